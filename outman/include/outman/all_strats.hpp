@@ -5,3 +5,12 @@
 #include "strategies/logging_csv_writer.hpp"
 #include "strategies/async_csv_file_strat.hpp"
 #include "strategies/async_save_strat_logs.hpp"
+#include "strategies/buffered_file_strat.hpp"
+#include "strategies/byte_sink_strat.hpp"
+#include "strategies/columnar_file_strat.hpp"
+#include "strategies/uring_file_strat.hpp"
+#include "strategies/direct_file_strat.hpp"
+#include "strategies/rotating_file_strat.hpp"
+#if !defined(_WIN32)
+#include "strategies/mapped_file_strat.hpp"
+#endif
@@ -0,0 +1,63 @@
+#ifndef OUTMAN_BACKPRESSURE_HPP
+#define OUTMAN_BACKPRESSURE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace outman {
+    // What a strategy queue does with a new record once it holds `capacity`.
+    enum class BackpressurePolicy {
+        Block,        // Producer waits for room (TrySaveAsync fails instead)
+        FailFast,     // Record is rejected and reported to TrySaveAsync callers
+        DropNewest,   // Record is silently discarded
+        DropOldest,   // Oldest queued record is discarded to make room
+        KeepEveryNth  // One in `keep_every` records replaces the oldest, the rest are discarded
+    };
+
+    struct QueueLimits {
+        // Maximum number of records queued for the strategy; 0 means unbounded.
+        std::size_t capacity = 0;
+        BackpressurePolicy policy = BackpressurePolicy::Block;
+        std::size_t keep_every = 10;
+    };
+
+    // Counters of one strategy queue. Every rejected record is counted once,
+    // under the policy that rejected it.
+    struct BackpressureStats {
+        std::uint64_t accepted = 0;
+        std::uint64_t blocked = 0;        // Times a producer had to wait for room
+        std::uint64_t rejected = 0;       // FailFast, or Block under TrySaveAsync
+        std::uint64_t dropped_newest = 0;
+        std::uint64_t dropped_oldest = 0;
+        std::uint64_t sampled_out = 0;    // KeepEveryNth
+        std::size_t queued = 0;
+    };
+
+    // Reported to save completions when a strategy queue rejected or
+    // discarded the record.
+    class RecordDroppedError : public std::runtime_error {
+    public:
+        explicit RecordDroppedError(BackpressurePolicy policy)
+            : std::runtime_error("record dropped by a full strategy queue"), _policy(policy) {}
+
+        BackpressurePolicy Policy() const {
+            return _policy;
+        }
+
+    private:
+        BackpressurePolicy _policy;
+    };
+
+    // Outcome of TrySaveAsync over all strategies registered for the type.
+    struct SaveAsyncResult {
+        std::size_t accepted = 0;
+        std::size_t rejected = 0;
+
+        bool Ok() const {
+            return rejected == 0;
+        }
+    };
+}
+
+#endif  // OUTMAN_BACKPRESSURE_HPP
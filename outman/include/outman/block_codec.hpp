@@ -0,0 +1,39 @@
+#ifndef OUTMAN_BLOCK_CODEC_HPP
+#define OUTMAN_BLOCK_CODEC_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "detail/gzip_file.hpp"
+
+namespace outman {
+    // Compresses one block into a self-contained frame, so blocks can be
+    // compressed independently and their frames concatenated in order.
+    // Compress is called from several threads at once.
+    class IBlockCodec {
+    public:
+        virtual ~IBlockCodec() = default;
+
+        // Appends the frame for `data` to `out`.
+        virtual void Compress(const char* data, std::size_t size, std::string& out) const = 0;
+    };
+
+#if OUTMAN_WITH_ZLIB
+    // Every block becomes a gzip member; the concatenation is a valid .gz
+    // file, as written by pigz --independent or bgzip.
+    class GzipBlockCodec : public IBlockCodec {
+    public:
+        // zlib level from 1 (fastest) to 9 (smallest); -1 for zlib's default.
+        explicit GzipBlockCodec(int level = -1) : _level(level) {}
+
+        void Compress(const char* data, std::size_t size, std::string& out) const override {
+            detail::GzipBlock(data, size, out, _level);
+        }
+
+    private:
+        const int _level;
+    };
+#endif
+}
+
+#endif  // OUTMAN_BLOCK_CODEC_HPP
@@ -0,0 +1,240 @@
+#ifndef OUTMAN_BLOCK_COMPRESSION_SINK_HPP
+#define OUTMAN_BLOCK_COMPRESSION_SINK_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/post.hpp>
+
+#include "block_codec.hpp"
+#include "byte_sink.hpp"
+
+namespace outman {
+    // Compresses the bytes written to it in independent blocks, pigz-style:
+    // every full block is compressed on the manager's executor while the
+    // next one fills, and the frames reach the next sink strictly in order.
+    // Up to `max_in_flight` blocks are compressed at once; a writer that
+    // gets ahead of that, or flushes, compresses waiting blocks itself
+    // instead of just blocking, so the sink also works on a busy or
+    // single-threaded pool, and inline when no executor was bound.
+    //
+    // Compression and write failures are thrown by the next Write or Flush.
+    class BlockCompressionSink : public IByteSink {
+    public:
+        static constexpr std::size_t kDefaultBlockSize = std::size_t(1) << 20;
+
+        // `max_in_flight` 0 means twice the hardware threads.
+        BlockCompressionSink(
+            std::shared_ptr<IByteSink> next,
+            std::shared_ptr<const IBlockCodec> codec,
+            std::size_t block_size = kDefaultBlockSize,
+            std::size_t max_in_flight = 0
+        )
+            : _block_size(block_size ? block_size : kDefaultBlockSize), _state(std::make_shared<State>()) {
+            _state->next = std::move(next);
+            _state->codec = std::move(codec);
+            _state->max_in_flight = max_in_flight ? max_in_flight
+                : std::max<std::size_t>(2 * std::thread::hardware_concurrency(), 2);
+            _current.reserve(_block_size);
+        }
+
+        ~BlockCompressionSink() override {
+            try {
+                Flush();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "outman: block compression failed: " << e.what() << std::endl;
+            }
+        }
+
+        BlockCompressionSink(const BlockCompressionSink&) = delete;
+        BlockCompressionSink& operator=(const BlockCompressionSink&) = delete;
+
+        void Write(const char* data, std::size_t size) override {
+            ThrowIfFailed();
+            while (size > 0) {
+                std::size_t chunk = std::min(size, _block_size - _current.size());
+                _current.append(data, chunk);
+                data += chunk;
+                size -= chunk;
+                if (_current.size() == _block_size) {
+                    SubmitCurrent();
+                }
+            }
+        }
+
+        void Flush() override {
+            if (!_current.empty()) {
+                SubmitCurrent();
+            }
+            WaitUntil([this]() { return _state->in_flight == 0; });
+            ThrowIfFailed();
+            _state->next->Flush();
+        }
+
+        // Keeps the first executor bound, and binds the next sink as well.
+        void BindExecutor(const boost::asio::any_io_executor& executor) override {
+            {
+                std::lock_guard<std::mutex> lock(_state->mutex);
+                if (!_executor) {
+                    _executor = executor;
+                }
+            }
+            _state->next->BindExecutor(executor);
+        }
+
+    private:
+        struct Block {
+            std::uint64_t sequence = 0;
+            std::string data;
+        };
+
+        struct Frame {
+            std::string data;
+            std::exception_ptr error;
+        };
+
+        // Shared with the tasks posted to the executor, which may run after
+        // the sink is gone and then find nothing left to do.
+        struct State {
+            std::shared_ptr<IByteSink> next;
+            std::shared_ptr<const IBlockCodec> codec;
+            std::size_t max_in_flight = 0;
+
+            std::mutex mutex;
+            std::condition_variable progress;
+            // Blocks not yet picked up, frames not yet written, and blocks
+            // submitted but not written.
+            std::deque<Block> waiting;
+            std::map<std::uint64_t, Frame> done;
+            std::size_t in_flight = 0;
+            std::uint64_t next_to_write = 0;
+            bool writing = false;
+            std::exception_ptr error;
+        };
+
+        void SubmitCurrent() {
+            WaitUntil([this]() { return _state->in_flight < _state->max_in_flight; });
+            boost::asio::any_io_executor executor;
+            {
+                std::lock_guard<std::mutex> lock(_state->mutex);
+                _state->waiting.push_back({ _next_sequence++, std::move(_current) });
+                ++_state->in_flight;
+                executor = _executor;
+            }
+            _current = std::string();
+            _current.reserve(_block_size);
+
+            if (executor) {
+                boost::asio::post(executor, [state = _state]() { CompressOne(*state); });
+            }
+            else {
+                CompressOne(*_state);
+            }
+        }
+
+        // Waits for `ready`, compressing waiting blocks meanwhile.
+        template <typename TPredicate>
+        void WaitUntil(TPredicate ready) {
+            std::unique_lock<std::mutex> lock(_state->mutex);
+            while (!ready()) {
+                if (!_state->waiting.empty()) {
+                    lock.unlock();
+                    CompressOne(*_state);
+                    lock.lock();
+                }
+                else {
+                    _state->progress.wait(lock);
+                }
+            }
+        }
+
+        static void CompressOne(State& state) {
+            Block block;
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                if (state.waiting.empty()) {
+                    return;
+                }
+                block = std::move(state.waiting.front());
+                state.waiting.pop_front();
+            }
+            Frame frame;
+            try {
+                state.codec->Compress(block.data.data(), block.data.size(), frame.data);
+            }
+            catch (...) {
+                frame.error = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                state.done.emplace(block.sequence, std::move(frame));
+            }
+            WriteInOrder(state);
+        }
+
+        // Whoever finds the next frame ready writes it, and every frame
+        // after it that is ready too; one thread writes at a time.
+        static void WriteInOrder(State& state) {
+            for (;;) {
+                Frame frame;
+                {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    auto it = state.done.find(state.next_to_write);
+                    if (state.writing || it == state.done.end()) {
+                        return;
+                    }
+                    frame = std::move(it->second);
+                    state.done.erase(it);
+                    state.writing = true;
+                }
+                std::exception_ptr error = frame.error;
+                if (!error) {
+                    try {
+                        state.next->Write(frame.data.data(), frame.data.size());
+                    }
+                    catch (...) {
+                        error = std::current_exception();
+                    }
+                }
+                {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    if (error && !state.error) {
+                        state.error = error;
+                    }
+                    state.writing = false;
+                    ++state.next_to_write;
+                    --state.in_flight;
+                }
+                state.progress.notify_all();
+            }
+        }
+
+        void ThrowIfFailed() {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            if (_state->error) {
+                std::rethrow_exception(std::exchange(_state->error, nullptr));
+            }
+        }
+
+        const std::size_t _block_size;
+        std::shared_ptr<State> _state;
+        // Written by the owner only; the executor under the state's mutex.
+        std::string _current;
+        std::uint64_t _next_sequence = 0;
+        boost::asio::any_io_executor _executor;
+    };
+}
+
+#endif  // OUTMAN_BLOCK_COMPRESSION_SINK_HPP
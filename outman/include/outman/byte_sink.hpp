@@ -0,0 +1,50 @@
+#ifndef OUTMAN_BYTE_SINK_HPP
+#define OUTMAN_BYTE_SINK_HPP
+
+#include <cstddef>
+#include <string>
+#include <boost/asio/any_io_executor.hpp>
+
+#include "detail/file_handle.hpp"
+
+namespace outman {
+    // Destination of the bytes a strategy formats, so that stages such as
+    // BlockCompressionSink can be put between a strategy and its file.
+    // The owner serializes calls to Write and Flush.
+    class IByteSink {
+    public:
+        virtual ~IByteSink() = default;
+
+        virtual void Write(const char* data, std::size_t size) = 0;
+
+        // Pushes everything written so far through to the final destination.
+        virtual void Flush() = 0;
+
+        // Called with the manager's executor when the owning strategy is
+        // added to a manager; stages that run work in parallel post it
+        // there and pass the executor on.
+        virtual void BindExecutor(const boost::asio::any_io_executor&) {}
+    };
+
+    // Appends to a file through one descriptor kept open.
+    class FileByteSink : public IByteSink {
+    public:
+        explicit FileByteSink(const std::string& file_name) : _file_name(file_name), _file(file_name) {}
+
+        void Write(const char* data, std::size_t size) override {
+            _file.Write(data, size);
+        }
+
+        void Flush() override {}
+
+        const std::string& FileName() const {
+            return _file_name;
+        }
+
+    private:
+        std::string _file_name;
+        detail::FileHandle _file;
+    };
+}
+
+#endif  // OUTMAN_BYTE_SINK_HPP
@@ -0,0 +1,45 @@
+#ifndef OUTMAN_CHANNEL_OPTIONS_HPP
+#define OUTMAN_CHANNEL_OPTIONS_HPP
+
+#include <chrono>
+#include <cstddef>
+
+namespace outman {
+    enum class IngestionMode {
+        // Records go straight into the per-strategy queues.
+        Queue,
+        // Records go into a pre-allocated lock-free ring per channel and a
+        // single drain task fans them out to the strategies in batches.
+        // Producers pay a few atomic operations per record and never touch
+        // the scheduler unless the drain is idle.
+        Ring
+    };
+
+    // Per record type settings, applied with OutputManager::ConfigureChannel.
+    struct ChannelOptions {
+        IngestionMode ingestion = IngestionMode::Queue;
+
+        // Ring mode: number of records the ring holds (rounded up to a power
+        // of two). When it is full SaveAsync spins until there is room and
+        // TrySaveAsync rejects. While a strategy queue with the Block policy
+        // is full the drain leaves records in the ring, so producers meet the
+        // backpressure there and no record is lost.
+        std::size_t ring_capacity = 4096;
+
+        // Ring mode: records fanned out per drain task.
+        std::size_t drain_batch = 256;
+
+        // Thread-local producer batching, off when 0. SaveAsync appends to a
+        // buffer owned by the calling thread, and the buffer is handed to the
+        // strategy queues as one batch once it holds batch_size records, once
+        // its oldest record is batch_age old, or when the thread exits.
+        // Batching takes precedence over the ring; TrySaveAsync bypasses it
+        // because it has to report acceptance right away. A hand-off into a
+        // full strategy queue with the Block policy waits for room as
+        // SaveAsync would, so no record is lost.
+        std::size_t batch_size = 0;
+        std::chrono::milliseconds batch_age{ 10 };
+    };
+}
+
+#endif  // OUTMAN_CHANNEL_OPTIONS_HPP
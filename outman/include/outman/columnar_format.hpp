@@ -0,0 +1,106 @@
+#ifndef OUTMAN_COLUMNAR_FORMAT_HPP
+#define OUTMAN_COLUMNAR_FORMAT_HPP
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Columnar files written by ColumnarFileStrat and read by
+// ColumnarFileReader. All numbers are little-endian; "varint" is LEB128
+// and signed varints are zigzag-encoded.
+//
+//     magic                  8 bytes, kColumnarMagic
+//     row group 0            one chunk per column, in schema order
+//     ...
+//     footer                 schema, then per row group its row count and,
+//                            per column chunk: offset, size, encoding and
+//                            min/max statistics
+//     footer size            u32
+//     magic                  8 bytes
+//
+// Readers start at the end, read the footer and then only the chunks of
+// the columns they need.
+namespace outman {
+    constexpr char kColumnarMagic[8] = { 'O', 'M', 'C', 'O', 'L', 'v', '0', '1' };
+
+    enum class ColumnType : std::uint8_t {
+        Unsupported = 0,
+        Bool,
+        Int8,
+        Int16,
+        Int32,
+        Int64,
+        UInt8,
+        UInt16,
+        UInt32,
+        UInt64,
+        Float32,
+        Float64,
+        String
+    };
+
+    enum class ColumnEncoding : std::uint8_t {
+        // Picks the smallest of the encodings that apply, per row group.
+        Auto = 0,
+        // Values one after another: fixed width, strings length-prefixed.
+        Plain,
+        // Distinct values once, then a varint index per row.
+        Dictionary,
+        // Integers only: the first value, then varint differences.
+        Delta,
+        // Integers and bools only: (value, run length) varint pairs.
+        Rle
+    };
+
+    // Column type of a field type; enums are stored as their underlying type.
+    template <typename TValue>
+    constexpr ColumnType ColumnTypeOf() {
+        if constexpr (std::is_enum_v<TValue>) {
+            return ColumnTypeOf<std::underlying_type_t<TValue>>();
+        }
+        else if constexpr (std::is_same_v<TValue, bool>) {
+            return ColumnType::Bool;
+        }
+        else if constexpr (std::is_integral_v<TValue>) {
+            constexpr bool is_signed = std::is_signed_v<TValue>;
+            switch (sizeof(TValue)) {
+            case 1: return is_signed ? ColumnType::Int8 : ColumnType::UInt8;
+            case 2: return is_signed ? ColumnType::Int16 : ColumnType::UInt16;
+            case 4: return is_signed ? ColumnType::Int32 : ColumnType::UInt32;
+            default: return is_signed ? ColumnType::Int64 : ColumnType::UInt64;
+            }
+        }
+        else if constexpr (std::is_same_v<TValue, float>) {
+            return ColumnType::Float32;
+        }
+        else if constexpr (std::is_same_v<TValue, double>) {
+            return ColumnType::Float64;
+        }
+        else if constexpr (std::is_same_v<TValue, std::string>) {
+            return ColumnType::String;
+        }
+        else {
+            return ColumnType::Unsupported;
+        }
+    }
+
+    template <typename TValue>
+    constexpr bool kIsIntegerColumn = std::is_integral_v<TValue> || std::is_enum_v<TValue>;
+
+    template <typename TValue>
+    constexpr bool SupportsEncoding(ColumnEncoding encoding) {
+        switch (encoding) {
+        case ColumnEncoding::Auto:
+        case ColumnEncoding::Plain:
+        case ColumnEncoding::Dictionary:
+            return true;
+        case ColumnEncoding::Delta:
+            return kIsIntegerColumn<TValue> && !std::is_same_v<TValue, bool>;
+        case ColumnEncoding::Rle:
+            return kIsIntegerColumn<TValue>;
+        }
+        return false;
+    }
+}
+
+#endif  // OUTMAN_COLUMNAR_FORMAT_HPP
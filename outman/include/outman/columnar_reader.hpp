@@ -0,0 +1,168 @@
+#ifndef OUTMAN_COLUMNAR_READER_HPP
+#define OUTMAN_COLUMNAR_READER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "columnar_format.hpp"
+#include "detail/columnar_encoding.hpp"
+
+namespace outman {
+    // Reads files written by ColumnarFileStrat. Opening reads the footer
+    // only; ReadColumn then reads the chunks of that one column, and
+    // Stats lets a scan skip row groups without reading them at all.
+    // Format errors throw std::runtime_error.
+    class ColumnarFileReader {
+    public:
+        explicit ColumnarFileReader(const std::string& file_name)
+            : _file_name(file_name), _in(file_name, std::ios::binary) {
+            if (!_in) {
+                throw std::runtime_error("outman: cannot open " + file_name);
+            }
+            _in.seekg(0, std::ios::end);
+            auto file_size = static_cast<std::uint64_t>(_in.tellg());
+            constexpr std::size_t kTail = 4 + sizeof(kColumnarMagic);
+            if (file_size < sizeof(kColumnarMagic) + kTail) {
+                throw std::runtime_error("outman: not a columnar file: " + file_name);
+            }
+            std::string tail = ReadAt(file_size - kTail, kTail);
+            if (std::memcmp(tail.data() + 4, kColumnarMagic, sizeof(kColumnarMagic)) != 0) {
+                throw std::runtime_error("outman: not a columnar file: " + file_name);
+            }
+            detail::ByteReader size_reader(tail.data(), 4);
+            std::uint64_t footer_size = size_reader.Fixed(4);
+            if (footer_size > file_size - sizeof(kColumnarMagic) - kTail) {
+                detail::ByteReader::Corrupt();
+            }
+            std::uint64_t footer_offset = file_size - kTail - footer_size;
+            std::string footer = ReadAt(footer_offset, static_cast<std::size_t>(footer_size));
+            _meta = detail::ParseFooter(footer.data(), footer.size());
+            // Chunks lie between the leading magic and the footer.
+            for (const auto& group : _meta.row_groups) {
+                for (const auto& chunk : group.chunks) {
+                    if (chunk.offset < sizeof(kColumnarMagic) || chunk.offset > footer_offset || chunk.size > footer_offset - chunk.offset) {
+                        detail::ByteReader::Corrupt();
+                    }
+                }
+            }
+        }
+
+        std::size_t ColumnCount() const {
+            return _meta.columns.size();
+        }
+
+        const std::string& ColumnName(std::size_t column) const {
+            return _meta.columns.at(column).name;
+        }
+
+        ColumnType GetColumnType(std::size_t column) const {
+            return _meta.columns.at(column).type;
+        }
+
+        // Index of the column called `name`; throws std::out_of_range if none.
+        std::size_t ColumnIndex(const std::string& name) const {
+            for (std::size_t i = 0; i < _meta.columns.size(); ++i) {
+                if (_meta.columns[i].name == name) {
+                    return i;
+                }
+            }
+            throw std::out_of_range("outman: no column " + name + " in " + _file_name);
+        }
+
+        std::size_t RowGroupCount() const {
+            return _meta.row_groups.size();
+        }
+
+        std::uint64_t RowCount(std::size_t row_group) const {
+            return _meta.row_groups.at(row_group).rows;
+        }
+
+        std::uint64_t RowCount() const {
+            std::uint64_t rows = 0;
+            for (const auto& group : _meta.row_groups) {
+                rows += group.rows;
+            }
+            return rows;
+        }
+
+        ColumnEncoding Encoding(std::size_t row_group, std::size_t column) const {
+            return _meta.row_groups.at(row_group).chunks.at(column).encoding;
+        }
+
+        // Smallest and largest value of a column in a row group, if known.
+        template <typename TValue>
+        std::optional<std::pair<TValue, TValue>> Stats(std::size_t row_group, std::size_t column) const {
+            CheckType<TValue>(column);
+            const auto& chunk = _meta.row_groups.at(row_group).chunks.at(column);
+            if (!chunk.has_stats) {
+                return std::nullopt;
+            }
+            detail::ByteReader min(chunk.min.data(), chunk.min.size());
+            detail::ByteReader max(chunk.max.data(), chunk.max.size());
+            return std::make_pair(detail::GetPlain<TValue>(min), detail::GetPlain<TValue>(max));
+        }
+
+        // Appends a column's values in one row group to `out`. TValue has
+        // to be the column's type, as ColumnTypeOf maps it.
+        template <typename TValue>
+        void ReadColumn(std::size_t row_group, std::size_t column, std::vector<TValue>& out) {
+            CheckType<TValue>(column);
+            const auto& group = _meta.row_groups.at(row_group);
+            const auto& chunk = group.chunks.at(column);
+            std::string data = ReadAt(chunk.offset, static_cast<std::size_t>(chunk.size));
+            detail::ByteReader in(data.data(), data.size());
+            detail::DecodeColumn(chunk.encoding, in, static_cast<std::size_t>(group.rows), out);
+        }
+
+        // A whole column, across every row group.
+        template <typename TValue>
+        std::vector<TValue> ReadColumn(const std::string& name) {
+            std::size_t column = ColumnIndex(name);
+            // Up front only as many rows as the chunks have bytes; a row
+            // count beyond that is either Rle or corrupt, which DecodeColumn
+            // finds out.
+            std::size_t capacity = 0;
+            for (const auto& group : _meta.row_groups) {
+                capacity += static_cast<std::size_t>(std::min(group.rows, group.chunks[column].size));
+            }
+            std::vector<TValue> values;
+            values.reserve(capacity);
+            for (std::size_t group = 0; group < RowGroupCount(); ++group) {
+                ReadColumn(group, column, values);
+            }
+            return values;
+        }
+
+    private:
+        template <typename TValue>
+        void CheckType(std::size_t column) const {
+            if (GetColumnType(column) != ColumnTypeOf<TValue>()) {
+                throw std::invalid_argument("outman: column " + ColumnName(column) + " has another type");
+            }
+        }
+
+        std::string ReadAt(std::uint64_t offset, std::size_t size) {
+            std::string data(size, '\0');
+            _in.clear();
+            _in.seekg(static_cast<std::streamoff>(offset));
+            if (!_in.read(&data[0], static_cast<std::streamsize>(size))) {
+                throw std::runtime_error("outman: cannot read " + _file_name);
+            }
+            return data;
+        }
+
+        std::string _file_name;
+        std::ifstream _in;
+        detail::ColumnarFileMeta _meta;
+    };
+}
+
+#endif  // OUTMAN_COLUMNAR_READER_HPP
@@ -0,0 +1,25 @@
+#ifndef OUTMAN_SHARED_PAYLOAD_HPP
+#define OUTMAN_SHARED_PAYLOAD_HPP
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace outman {
+    // Immutable, reference-counted record. One payload is shared by every
+    // strategy registered for its type, so a save never deep-copies per sink.
+    template <typename TData>
+    using SharedPayload = std::shared_ptr<const TData>;
+
+    template <typename TData>
+    SharedPayload<std::decay_t<TData>> MakePayload(TData&& data) {
+        return std::make_shared<const std::decay_t<TData>>(std::forward<TData>(data));
+    }
+
+    template <typename TData>
+    SharedPayload<TData> MakePayload(std::unique_ptr<TData> data) {
+        return SharedPayload<TData>(std::move(data));
+    }
+}
+
+#endif  // OUTMAN_SHARED_PAYLOAD_HPP
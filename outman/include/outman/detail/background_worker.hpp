@@ -0,0 +1,109 @@
+#ifndef OUTMAN_DETAIL_BACKGROUND_WORKER_HPP
+#define OUTMAN_DETAIL_BACKGROUND_WORKER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "save_completion.hpp"
+#include "thread_setup.hpp"
+
+namespace outman {
+    namespace detail {
+        // A thread at idle scheduling priority for a sink's housekeeping
+        // (compressing, opening files ahead) that must not take CPU from the
+        // manager's workers. Tasks run in order; urgent ones overtake the
+        // waiting tasks, but never the one running. Errors go to std::cerr.
+        //
+        // The destructor runs every queued task before it joins.
+        class BackgroundWorker {
+        public:
+            explicit BackgroundWorker(const std::string& name) {
+                _thread = std::thread([this, name]() {
+                    ApplyThreadSettings(name, {}, SchedulingPolicy::Idle, 0);
+                    Run();
+                });
+            }
+
+            ~BackgroundWorker() {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stop = true;
+                }
+                _wake.notify_one();
+                _thread.join();
+            }
+
+            BackgroundWorker(const BackgroundWorker&) = delete;
+            BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+
+            void Post(std::function<void()> task) {
+                Enqueue(std::move(task), false);
+            }
+
+            void PostUrgent(std::function<void()> task) {
+                Enqueue(std::move(task), true);
+            }
+
+            // Blocks until every task posted so far has run.
+            void WaitIdle() {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _idle.wait(lock, [this]() { return _tasks.empty() && !_busy; });
+            }
+
+        private:
+            void Enqueue(std::function<void()> task, bool urgent) {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (urgent) {
+                        _tasks.push_front(std::move(task));
+                    }
+                    else {
+                        _tasks.push_back(std::move(task));
+                    }
+                }
+                _wake.notify_one();
+            }
+
+            void Run() {
+                std::unique_lock<std::mutex> lock(_mutex);
+                for (;;) {
+                    _wake.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+                    if (_tasks.empty()) {
+                        return;
+                    }
+                    auto task = std::move(_tasks.front());
+                    _tasks.pop_front();
+                    _busy = true;
+                    lock.unlock();
+                    try {
+                        task();
+                    }
+                    catch (...) {
+                        ReportSaveError(std::current_exception());
+                    }
+                    lock.lock();
+                    _busy = false;
+                    if (_tasks.empty()) {
+                        _idle.notify_all();
+                    }
+                }
+            }
+
+            std::mutex _mutex;
+            std::condition_variable _wake;
+            std::condition_variable _idle;
+            std::deque<std::function<void()>> _tasks;
+            bool _busy = false;
+            bool _stop = false;
+            std::thread _thread;
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_BACKGROUND_WORKER_HPP
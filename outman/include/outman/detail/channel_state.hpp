@@ -0,0 +1,161 @@
+#ifndef OUTMAN_DETAIL_CHANNEL_STATE_HPP
+#define OUTMAN_DETAIL_CHANNEL_STATE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "../channel_options.hpp"
+#include "producer_batcher.hpp"
+#include "ring_ingestion.hpp"
+#include "strategy_slot.hpp"
+
+namespace outman {
+    namespace detail {
+        template <typename TData>
+        using StrategyList = std::vector<std::shared_ptr<StrategySlot<TData>>>;
+
+        // Type-erased view used by OutputManager::Shutdown. Callers must hold
+        // the registry lock (shared is enough).
+        class ChannelStateBase {
+        public:
+            virtual ~ChannelStateBase() = default;
+
+            // True when the ring and every strategy queue are idle.
+            virtual bool Idle() const = 0;
+
+            // Records waiting in the ring and the strategy queues.
+            virtual std::size_t Pending() const = 0;
+
+            // Asks the flushable and group-committing strategies for a flush
+            // (a commit) in their own lanes, after the records queued so far.
+            // Idle() turns true again once every one of them ran.
+            virtual void RequestFlush() const = 0;
+        };
+
+        template <typename TData>
+        class ChannelState;
+
+        // What a producer needs to submit a record, read under the registry
+        // lock once and then cached by channel handles.
+        template <typename TData>
+        struct ChannelView {
+            std::shared_ptr<ChannelState<TData>> state;
+            std::shared_ptr<const StrategyList<TData>> strategies;
+            std::shared_ptr<RingIngestion<TData>> ring;
+            std::shared_ptr<ProducerBatcher<TData>> batcher;
+        };
+
+        // Per-type registry entry. The strategy list and the ingestion stages are
+        // copy-on-write: they are only replaced under the manager's exclusive
+        // registry lock, and every replacement bumps the version so channel
+        // handles can tell their cached view went stale without taking any lock.
+        template <typename TData>
+        class ChannelState : public ChannelStateBase {
+        public:
+            // Posts a drain task for a slot whose queue asked for one.
+            using DrainScheduler = std::function<void(const std::shared_ptr<StrategySlot<TData>>&)>;
+
+            explicit ChannelState(DrainScheduler schedule_drain)
+                : _strategies(std::make_shared<const StrategyList<TData>>()), _schedule_drain(std::move(schedule_drain)) {}
+
+            // Caller must hold the registry lock (shared is enough).
+            const std::shared_ptr<const StrategyList<TData>>& Strategies() const {
+                return _strategies;
+            }
+
+            // Caller must hold the registry lock (shared is enough).
+            const std::shared_ptr<RingIngestion<TData>>& Ring() const {
+                return _ring;
+            }
+
+            // Caller must hold the registry lock (shared is enough).
+            const std::shared_ptr<ProducerBatcher<TData>>& Batcher() const {
+                return _batcher;
+            }
+
+            // Caller must hold the registry lock (shared is enough).
+            ChannelView<TData> View(std::shared_ptr<ChannelState<TData>> self) const {
+                return { std::move(self), _strategies, _ring, _batcher };
+            }
+
+            bool Idle() const override {
+                if (_ring && !_ring->Idle()) {
+                    return false;
+                }
+                for (const auto& slot : *_strategies) {
+                    if (!slot->Queue().Idle()) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            std::size_t Pending() const override {
+                std::size_t pending = _ring ? _ring->Stats().queued : 0;
+                for (const auto& slot : *_strategies) {
+                    pending += slot->Queue().Stats().queued;
+                }
+                return pending;
+            }
+
+            void RequestFlush() const override {
+                for (const auto& slot : *_strategies) {
+                    if ((slot->Kind() == StrategyKind::Flushable || slot->Committer()) && slot->Queue().RequestFlush(true)) {
+                        _schedule_drain(slot);
+                    }
+                }
+            }
+
+            std::uint64_t Version() const {
+                return _version.load(std::memory_order_acquire);
+            }
+
+            // Caller must hold the registry lock exclusively.
+            std::shared_ptr<StrategySlot<TData>> Add(
+                std::shared_ptr<ISavingStrategy<TData>> strategy,
+                const QueueLimits& limits,
+                OutputPriority priority,
+                const std::optional<FlushPolicy>& flush_policy = std::nullopt
+            ) {
+                auto slot = std::make_shared<StrategySlot<TData>>(std::move(strategy), limits, priority, flush_policy);
+                auto strategies = std::make_shared<StrategyList<TData>>(*_strategies);
+                strategies->push_back(slot);
+                _strategies = std::move(strategies);
+                _version.fetch_add(1, std::memory_order_release);
+                return slot;
+            }
+
+            // Caller must hold the registry lock exclusively. Returns the
+            // batcher that was replaced, if any.
+            std::shared_ptr<ProducerBatcher<TData>> Configure(
+                const ChannelOptions& options,
+                std::shared_ptr<ProducerBatcher<TData>> batcher
+            ) {
+                if (options.ingestion == IngestionMode::Ring) {
+                    _ring = std::make_shared<RingIngestion<TData>>(options);
+                }
+                else {
+                    _ring.reset();
+                }
+                std::swap(_batcher, batcher);
+                _version.fetch_add(1, std::memory_order_release);
+                return batcher;
+            }
+
+        private:
+            std::shared_ptr<const StrategyList<TData>> _strategies;
+            std::shared_ptr<RingIngestion<TData>> _ring;
+            std::shared_ptr<ProducerBatcher<TData>> _batcher;
+            DrainScheduler _schedule_drain;
+            // Written only on registration, so readers share the line cleanly.
+            alignas(64) std::atomic<std::uint64_t> _version{ 0 };
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_CHANNEL_STATE_HPP
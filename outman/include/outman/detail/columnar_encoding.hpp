@@ -0,0 +1,491 @@
+#ifndef OUTMAN_DETAIL_COLUMNAR_ENCODING_HPP
+#define OUTMAN_DETAIL_COLUMNAR_ENCODING_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "../columnar_format.hpp"
+
+namespace outman {
+    namespace detail {
+        inline void PutVarint(std::string& out, std::uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        inline std::uint64_t ZigZag(std::int64_t value) {
+            return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+        }
+
+        inline std::int64_t UnZigZag(std::uint64_t value) {
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+
+        inline void PutFixed(std::string& out, std::uint64_t value, std::size_t width) {
+            for (std::size_t i = 0; i < width; ++i) {
+                out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+            }
+        }
+
+        // Bounds-checked cursor over encoded bytes; running past the end
+        // throws instead of reading garbage.
+        class ByteReader {
+        public:
+            ByteReader(const char* data, std::size_t size) : _next(data), _end(data + size) {}
+
+            const char* Take(std::size_t size) {
+                if (static_cast<std::size_t>(_end - _next) < size) {
+                    Corrupt();
+                }
+                const char* data = _next;
+                _next += size;
+                return data;
+            }
+
+            std::uint64_t Fixed(std::size_t width) {
+                const char* data = Take(width);
+                std::uint64_t value = 0;
+                for (std::size_t i = 0; i < width; ++i) {
+                    value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+                }
+                return value;
+            }
+
+            std::uint64_t Varint() {
+                std::uint64_t value = 0;
+                for (int shift = 0; shift < 64; shift += 7) {
+                    auto byte = static_cast<unsigned char>(*Take(1));
+                    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+                    if (!(byte & 0x80)) {
+                        return value;
+                    }
+                }
+                Corrupt();
+            }
+
+            std::size_t Remaining() const {
+                return static_cast<std::size_t>(_end - _next);
+            }
+
+            [[noreturn]] static void Corrupt() {
+                throw std::runtime_error("outman: corrupt columnar data");
+            }
+
+        private:
+            const char* _next;
+            const char* _end;
+        };
+
+        // Integers (and bools and enums) as 64-bit patterns, sign-extended.
+        template <typename TValue>
+        std::uint64_t ToBits(const TValue& value) {
+            if constexpr (std::is_enum_v<TValue>) {
+                return ToBits(static_cast<std::underlying_type_t<TValue>>(value));
+            }
+            else if constexpr (std::is_signed_v<TValue>) {
+                return static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+            }
+            else {
+                return static_cast<std::uint64_t>(value);
+            }
+        }
+
+        template <typename TValue>
+        TValue FromBits(std::uint64_t bits) {
+            if constexpr (std::is_enum_v<TValue>) {
+                return static_cast<TValue>(FromBits<std::underlying_type_t<TValue>>(bits));
+            }
+            else if constexpr (std::is_same_v<TValue, bool>) {
+                return bits != 0;
+            }
+            else {
+                return static_cast<TValue>(bits);
+            }
+        }
+
+        template <typename TValue>
+        std::uint64_t FloatBits(TValue value) {
+            if constexpr (sizeof(TValue) == 4) {
+                std::uint32_t bits;
+                std::memcpy(&bits, &value, 4);
+                return bits;
+            }
+            else {
+                std::uint64_t bits;
+                std::memcpy(&bits, &value, 8);
+                return bits;
+            }
+        }
+
+        template <typename TValue>
+        void PutPlain(std::string& out, const TValue& value) {
+            if constexpr (std::is_same_v<TValue, std::string>) {
+                PutVarint(out, value.size());
+                out.append(value);
+            }
+            else if constexpr (std::is_floating_point_v<TValue>) {
+                PutFixed(out, FloatBits(value), sizeof(TValue));
+            }
+            else {
+                PutFixed(out, ToBits(value), sizeof(TValue));
+            }
+        }
+
+        template <typename TValue>
+        TValue GetPlain(ByteReader& in) {
+            if constexpr (std::is_same_v<TValue, std::string>) {
+                std::size_t size = static_cast<std::size_t>(in.Varint());
+                return std::string(in.Take(size), size);
+            }
+            else if constexpr (std::is_floating_point_v<TValue>) {
+                TValue value;
+                if constexpr (sizeof(TValue) == 4) {
+                    auto bits = static_cast<std::uint32_t>(in.Fixed(4));
+                    std::memcpy(&value, &bits, 4);
+                }
+                else {
+                    auto bits = in.Fixed(8);
+                    std::memcpy(&value, &bits, 8);
+                }
+                return value;
+            }
+            else {
+                std::uint64_t bits = in.Fixed(sizeof(TValue));
+                // Sign-extend narrow signed values back to 64 bits.
+                using Integer = std::conditional_t<std::is_enum_v<TValue>, std::underlying_type<TValue>, std::common_type<TValue>>;
+                if constexpr (std::is_signed_v<typename Integer::type> && sizeof(TValue) < 8) {
+                    std::uint64_t sign = std::uint64_t(1) << (8 * sizeof(TValue) - 1);
+                    bits = (bits ^ sign) - sign;
+                }
+                return FromBits<TValue>(bits);
+            }
+        }
+
+        // Floats are keyed by bit pattern, so -0.0 and NaNs survive.
+        template <typename TValue>
+        auto DictionaryKey(const TValue& value) {
+            if constexpr (std::is_floating_point_v<TValue>) {
+                return FloatBits(value);
+            }
+            else {
+                return value;
+            }
+        }
+
+        template <typename TValue>
+        void EncodePlain(const std::vector<TValue>& values, std::string& out) {
+            for (const auto& value : values) {
+                PutPlain(out, value);
+            }
+        }
+
+        // Gives up, returning false, past `max_entries` distinct values.
+        template <typename TValue>
+        bool EncodeDictionary(const std::vector<TValue>& values, std::string& out, std::size_t max_entries) {
+            using Key = decltype(DictionaryKey(std::declval<const TValue&>()));
+            std::unordered_map<Key, std::uint32_t> indices;
+            std::vector<const TValue*> entries;
+            std::vector<std::uint32_t> rows;
+            rows.reserve(values.size());
+            for (const auto& value : values) {
+                auto inserted = indices.emplace(DictionaryKey(value), static_cast<std::uint32_t>(entries.size()));
+                if (inserted.second) {
+                    if (entries.size() == max_entries) {
+                        return false;
+                    }
+                    entries.push_back(&value);
+                }
+                rows.push_back(inserted.first->second);
+            }
+            PutVarint(out, entries.size());
+            for (const auto* entry : entries) {
+                PutPlain(out, *entry);
+            }
+            for (auto index : rows) {
+                PutVarint(out, index);
+            }
+            return true;
+        }
+
+        template <typename TValue>
+        void EncodeDelta(const std::vector<TValue>& values, std::string& out) {
+            std::uint64_t previous = 0;
+            for (const auto& value : values) {
+                std::uint64_t bits = ToBits(value);
+                PutVarint(out, ZigZag(static_cast<std::int64_t>(bits - previous)));
+                previous = bits;
+            }
+        }
+
+        template <typename TValue>
+        void EncodeRle(const std::vector<TValue>& values, std::string& out) {
+            for (std::size_t i = 0; i < values.size();) {
+                std::size_t run = 1;
+                while (i + run < values.size() && values[i + run] == values[i]) {
+                    ++run;
+                }
+                PutVarint(out, ZigZag(static_cast<std::int64_t>(ToBits(values[i]))));
+                PutVarint(out, run);
+                i += run;
+            }
+        }
+
+        // Appends `values` to `out` in `requested`, or for Auto in whichever
+        // applicable encoding comes out smallest; returns the one used.
+        template <typename TValue>
+        ColumnEncoding EncodeColumn(ColumnEncoding requested, const std::vector<TValue>& values, std::string& out) {
+            switch (requested) {
+            case ColumnEncoding::Plain:
+                EncodePlain(values, out);
+                return requested;
+            case ColumnEncoding::Dictionary:
+                EncodeDictionary(values, out, std::numeric_limits<std::uint32_t>::max());
+                return requested;
+            case ColumnEncoding::Delta:
+                if constexpr (SupportsEncoding<TValue>(ColumnEncoding::Delta)) {
+                    EncodeDelta(values, out);
+                    return requested;
+                }
+                break;
+            case ColumnEncoding::Rle:
+                if constexpr (SupportsEncoding<TValue>(ColumnEncoding::Rle)) {
+                    EncodeRle(values, out);
+                    return requested;
+                }
+                break;
+            case ColumnEncoding::Auto:
+                break;
+            }
+
+            std::string best;
+            ColumnEncoding best_encoding = ColumnEncoding::Plain;
+            EncodePlain(values, best);
+            auto consider = [&](ColumnEncoding encoding, std::string& candidate) {
+                if (candidate.size() < best.size()) {
+                    best.swap(candidate);
+                    best_encoding = encoding;
+                }
+                candidate.clear();
+            };
+            std::string candidate;
+            if (EncodeDictionary(values, candidate, std::max<std::size_t>(values.size() / 2, 1))) {
+                consider(ColumnEncoding::Dictionary, candidate);
+            }
+            candidate.clear();
+            if constexpr (SupportsEncoding<TValue>(ColumnEncoding::Delta)) {
+                EncodeDelta(values, candidate);
+                consider(ColumnEncoding::Delta, candidate);
+            }
+            if constexpr (SupportsEncoding<TValue>(ColumnEncoding::Rle)) {
+                EncodeRle(values, candidate);
+                consider(ColumnEncoding::Rle, candidate);
+            }
+            out.append(best);
+            return best_encoding;
+        }
+
+        template <typename TValue>
+        void DecodeColumn(ColumnEncoding encoding, ByteReader& in, std::size_t count, std::vector<TValue>& out) {
+            // `count` comes from the footer. Every encoding but Rle spends at
+            // least a byte per value, so a count the chunk cannot hold is
+            // corrupt; Rle runs are checked against it as they are read.
+            if (encoding != ColumnEncoding::Rle) {
+                if (count > in.Remaining()) {
+                    ByteReader::Corrupt();
+                }
+                out.reserve(out.size() + count);
+            }
+            switch (encoding) {
+            case ColumnEncoding::Plain:
+                for (std::size_t i = 0; i < count; ++i) {
+                    out.push_back(GetPlain<TValue>(in));
+                }
+                return;
+            case ColumnEncoding::Dictionary: {
+                std::size_t size = static_cast<std::size_t>(in.Varint());
+                if (size > in.Remaining()) {
+                    ByteReader::Corrupt();
+                }
+                std::vector<TValue> entries;
+                entries.reserve(size);
+                for (std::size_t i = 0; i < size; ++i) {
+                    entries.push_back(GetPlain<TValue>(in));
+                }
+                for (std::size_t i = 0; i < count; ++i) {
+                    std::uint64_t index = in.Varint();
+                    if (index >= entries.size()) {
+                        ByteReader::Corrupt();
+                    }
+                    out.push_back(entries[static_cast<std::size_t>(index)]);
+                }
+                return;
+            }
+            case ColumnEncoding::Delta:
+                if constexpr (SupportsEncoding<TValue>(ColumnEncoding::Delta)) {
+                    std::uint64_t bits = 0;
+                    for (std::size_t i = 0; i < count; ++i) {
+                        bits += static_cast<std::uint64_t>(UnZigZag(in.Varint()));
+                        out.push_back(FromBits<TValue>(bits));
+                    }
+                    return;
+                }
+                break;
+            case ColumnEncoding::Rle:
+                if constexpr (SupportsEncoding<TValue>(ColumnEncoding::Rle)) {
+                    std::size_t decoded = 0;
+                    while (decoded < count) {
+                        TValue value = FromBits<TValue>(static_cast<std::uint64_t>(UnZigZag(in.Varint())));
+                        std::uint64_t run = in.Varint();
+                        if (run == 0 || run > count - decoded) {
+                            ByteReader::Corrupt();
+                        }
+                        out.insert(out.end(), static_cast<std::size_t>(run), value);
+                        decoded += static_cast<std::size_t>(run);
+                    }
+                    return;
+                }
+                break;
+            case ColumnEncoding::Auto:
+                break;
+            }
+            ByteReader::Corrupt();
+        }
+
+        // Statistics are skipped for strings longer than this, to keep the
+        // footer small.
+        constexpr std::size_t kMaxStatsLength = 256;
+
+        // Smallest and largest value, NaNs ignored. False if there is none.
+        template <typename TValue>
+        bool ColumnMinMax(const std::vector<TValue>& values, TValue& min, TValue& max) {
+            bool found = false;
+            for (const auto& value : values) {
+                if constexpr (std::is_floating_point_v<TValue>) {
+                    if (std::isnan(value)) {
+                        continue;
+                    }
+                }
+                if (!found) {
+                    min = max = value;
+                    found = true;
+                }
+                else if (value < min) {
+                    min = value;
+                }
+                else if (max < value) {
+                    max = value;
+                }
+            }
+            if constexpr (std::is_same_v<TValue, std::string>) {
+                found = found && min.size() <= kMaxStatsLength && max.size() <= kMaxStatsLength;
+            }
+            return found;
+        }
+
+        struct ColumnChunkMeta {
+            std::uint64_t offset = 0;
+            std::uint64_t size = 0;
+            ColumnEncoding encoding = ColumnEncoding::Plain;
+            bool has_stats = false;
+            // Plain-encoded, as the column's values are.
+            std::string min;
+            std::string max;
+        };
+
+        struct RowGroupMeta {
+            std::uint64_t rows = 0;
+            std::vector<ColumnChunkMeta> chunks;
+        };
+
+        struct ColumnMeta {
+            std::string name;
+            ColumnType type = ColumnType::Unsupported;
+        };
+
+        struct ColumnarFileMeta {
+            std::vector<ColumnMeta> columns;
+            std::vector<RowGroupMeta> row_groups;
+        };
+
+        // The footer together with its size and the closing magic.
+        inline void PutFooter(const ColumnarFileMeta& meta, std::string& out) {
+            std::size_t start = out.size();
+            PutVarint(out, meta.columns.size());
+            for (const auto& column : meta.columns) {
+                PutVarint(out, column.name.size());
+                out.append(column.name);
+                out.push_back(static_cast<char>(column.type));
+            }
+            PutVarint(out, meta.row_groups.size());
+            for (const auto& group : meta.row_groups) {
+                PutVarint(out, group.rows);
+                for (const auto& chunk : group.chunks) {
+                    PutVarint(out, chunk.offset);
+                    PutVarint(out, chunk.size);
+                    out.push_back(static_cast<char>(chunk.encoding));
+                    out.push_back(static_cast<char>(chunk.has_stats));
+                    if (chunk.has_stats) {
+                        PutVarint(out, chunk.min.size());
+                        out.append(chunk.min);
+                        PutVarint(out, chunk.max.size());
+                        out.append(chunk.max);
+                    }
+                }
+            }
+            PutFixed(out, out.size() - start, 4);
+            out.append(kColumnarMagic, sizeof(kColumnarMagic));
+        }
+
+        // `footer` is the footer alone, without its size and magic.
+        inline ColumnarFileMeta ParseFooter(const char* footer, std::size_t size) {
+            ByteReader in(footer, size);
+            ColumnarFileMeta meta;
+            std::size_t columns = static_cast<std::size_t>(in.Varint());
+            if (columns > in.Remaining()) {
+                ByteReader::Corrupt();
+            }
+            meta.columns.resize(columns);
+            for (auto& column : meta.columns) {
+                std::size_t length = static_cast<std::size_t>(in.Varint());
+                column.name.assign(in.Take(length), length);
+                column.type = static_cast<ColumnType>(in.Fixed(1));
+            }
+            std::size_t groups = static_cast<std::size_t>(in.Varint());
+            if (groups > in.Remaining()) {
+                ByteReader::Corrupt();
+            }
+            meta.row_groups.resize(groups);
+            for (auto& group : meta.row_groups) {
+                group.rows = in.Varint();
+                group.chunks.resize(columns);
+                for (auto& chunk : group.chunks) {
+                    chunk.offset = in.Varint();
+                    chunk.size = in.Varint();
+                    chunk.encoding = static_cast<ColumnEncoding>(in.Fixed(1));
+                    chunk.has_stats = in.Fixed(1) != 0;
+                    if (chunk.has_stats) {
+                        std::size_t length = static_cast<std::size_t>(in.Varint());
+                        chunk.min.assign(in.Take(length), length);
+                        length = static_cast<std::size_t>(in.Varint());
+                        chunk.max.assign(in.Take(length), length);
+                    }
+                }
+            }
+            return meta;
+        }
+    }
+}
+
+#endif  // OUTMAN_DETAIL_COLUMNAR_ENCODING_HPP
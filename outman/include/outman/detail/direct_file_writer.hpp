@@ -0,0 +1,324 @@
+#ifndef OUTMAN_DETAIL_DIRECT_FILE_WRITER_HPP
+#define OUTMAN_DETAIL_DIRECT_FILE_WRITER_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#include "file_handle.hpp"
+#include "io_uring.hpp"
+
+namespace outman {
+    namespace detail {
+        // Heap block aligned for direct I/O.
+        class AlignedBlock {
+        public:
+            AlignedBlock(std::size_t size, std::size_t alignment) : _size(size) {
+#if defined(_WIN32)
+                _data = static_cast<char*>(::_aligned_malloc(size, alignment));
+                if (!_data) {
+                    throw std::bad_alloc();
+                }
+#else
+                void* data = nullptr;
+                if (::posix_memalign(&data, alignment, size) != 0) {
+                    throw std::bad_alloc();
+                }
+                _data = static_cast<char*>(data);
+#endif
+            }
+
+            ~AlignedBlock() {
+#if defined(_WIN32)
+                ::_aligned_free(_data);
+#else
+                std::free(_data);
+#endif
+            }
+
+            AlignedBlock(const AlignedBlock&) = delete;
+            AlignedBlock& operator=(const AlignedBlock&) = delete;
+
+            char* Data() const {
+                return _data;
+            }
+
+            std::size_t Size() const {
+                return _size;
+            }
+
+        private:
+            char* _data = nullptr;
+            std::size_t _size = 0;
+        };
+
+        // Appends to a file with O_DIRECT, bypassing the page cache, from
+        // two aligned blocks: one fills while the other is written. With
+        // io_uring both blocks are registered buffers and a full block is
+        // written in the background; without it the full block is written
+        // on the calling thread.
+        //
+        // Direct I/O moves whole sectors only. Flush pads the last partial
+        // sector with zeros, waits for the write and truncates the file
+        // back to its logical size; that sector stays in the block and is
+        // rewritten in place once more data follows. A file that already
+        // ends in a partial sector is continued the same way.
+        //
+        // Where the file system refuses O_DIRECT (e.g. tmpfs) the file is
+        // opened normally and everything else stays the same.
+        //
+        // Not thread-safe; write failures are thrown by the next call.
+        class DirectFileWriter {
+        public:
+            static constexpr std::size_t kDefaultAlignment = 4096;
+
+            DirectFileWriter(const std::string& path, std::size_t block_size, std::size_t alignment = kDefaultAlignment)
+                : _alignment(std::max<std::size_t>(alignment, 512)),
+                _block_size(RoundUp(std::max(block_size, _alignment), _alignment)),
+                _file(Open(path, _direct_io)),
+                _blocks{ { _block_size, _alignment }, { _block_size, _alignment } } {
+#if OUTMAN_HAS_IO_URING
+                try {
+                    _ring = std::make_unique<IoUring>(2);
+                    iovec vectors[2] = {
+                        { _blocks[0].Data(), _block_size },
+                        { _blocks[1].Data(), _block_size }
+                    };
+                    try {
+                        _ring->RegisterBuffers(vectors, 2);
+                        _fixed_buffers = true;
+                    }
+                    catch (const std::system_error&) {
+                    }
+                }
+                catch (const std::system_error&) {
+                    _ring.reset();
+                }
+#endif
+                // Continue a file that ends mid-sector from that sector.
+                std::uint64_t size = _file.Size();
+                _block_offset = size / _alignment * _alignment;
+                _used = static_cast<std::size_t>(size - _block_offset);
+                if (_used > 0 && _file.ReadAt(_blocks[0].Data(), _alignment, _block_offset) < _used) {
+                    throw std::system_error(EIO, std::generic_category(), "outman: cannot read the tail of " + path);
+                }
+            }
+
+            ~DirectFileWriter() {
+                try {
+                    Flush();
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "outman: direct write failed: " << e.what() << std::endl;
+                }
+                try {
+                    WaitIdle();
+                }
+                catch (const std::exception&) {
+                }
+            }
+
+            DirectFileWriter(const DirectFileWriter&) = delete;
+            DirectFileWriter& operator=(const DirectFileWriter&) = delete;
+
+            bool UsesDirectIo() const {
+                return _direct_io;
+            }
+
+            bool UsesIoUring() const {
+#if OUTMAN_HAS_IO_URING
+                return _ring != nullptr;
+#else
+                return false;
+#endif
+            }
+
+            void Append(const char* data, std::size_t size) {
+                ThrowIfFailed();
+                while (size > 0) {
+                    std::size_t chunk = std::min(size, _block_size - _used);
+                    std::memcpy(_blocks[_current].Data() + _used, data, chunk);
+                    _used += chunk;
+                    data += chunk;
+                    size -= chunk;
+                    if (_used == _block_size) {
+                        SubmitFullBlock();
+                    }
+                }
+            }
+
+            // Writes everything appended so far and waits for it; see the
+            // class comment for the partial last sector.
+            void Flush() {
+                ThrowIfFailed();
+                if (_used == 0) {
+                    WaitIdle();
+                    return;
+                }
+                std::size_t padded = RoundUp(_used, _alignment);
+                std::memset(_blocks[_current].Data() + _used, 0, padded - _used);
+                StartWrite(_current, _block_offset, padded);
+                WaitIdle();
+                _file.Truncate(_block_offset + _used);
+
+                std::size_t whole = _used / _alignment * _alignment;
+                if (whole > 0) {
+                    std::memmove(_blocks[_current].Data(), _blocks[_current].Data() + whole, _used - whole);
+                    _block_offset += whole;
+                    _used -= whole;
+                }
+            }
+
+            FileHandle& File() {
+                return _file;
+            }
+
+        private:
+            struct Write {
+                std::uint64_t offset = 0;
+                std::size_t size = 0;
+                std::size_t written = 0;
+                bool in_flight = false;
+            };
+
+            static std::size_t RoundUp(std::size_t value, std::size_t alignment) {
+                return (value + alignment - 1) / alignment * alignment;
+            }
+
+            static FileHandle Open(const std::string& path, bool& direct_io) {
+#if defined(O_DIRECT)
+                try {
+                    FileHandle file(path, O_RDWR | O_DIRECT);
+                    direct_io = true;
+                    return file;
+                }
+                catch (const std::system_error& e) {
+                    if (e.code().value() != EINVAL) {
+                        throw;
+                    }
+                }
+#endif
+                direct_io = false;
+                return FileHandle(path, O_RDWR);
+            }
+
+            void ThrowIfFailed() {
+                if (_error) {
+                    std::rethrow_exception(std::exchange(_error, nullptr));
+                }
+            }
+
+            void SubmitFullBlock() {
+                StartWrite(_current, _block_offset, _block_size);
+                _block_offset += _block_size;
+                _used = 0;
+                _current ^= 1;
+                // The block to fill next may still be on its way out.
+                WaitFor(_current);
+            }
+
+            void StartWrite(int index, std::uint64_t offset, std::size_t size) {
+                Write& write = _writes[index];
+                write.offset = offset;
+                write.size = size;
+                write.written = 0;
+#if OUTMAN_HAS_IO_URING
+                if (_ring) {
+                    write.in_flight = true;
+                    QueueWrite(index);
+                    _ring->Submit();
+                    return;
+                }
+#endif
+                _file.WriteAt(_blocks[index].Data(), size, offset);
+            }
+
+            void WaitFor(int index) {
+#if OUTMAN_HAS_IO_URING
+                while (_writes[index].in_flight) {
+                    _ring->Submit(1);
+                    Reap();
+                }
+#else
+                (void)index;
+#endif
+                ThrowIfFailed();
+            }
+
+            void WaitIdle() {
+                WaitFor(0);
+                WaitFor(1);
+            }
+
+#if OUTMAN_HAS_IO_URING
+            void QueueWrite(int index) {
+                Write& write = _writes[index];
+                io_uring_sqe* sqe = _ring->NextSqe();
+                sqe->opcode = _fixed_buffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+                sqe->fd = _file.Native();
+                sqe->off = write.offset + write.written;
+                sqe->addr = reinterpret_cast<std::uint64_t>(_blocks[index].Data() + write.written);
+                sqe->len = static_cast<std::uint32_t>(write.size - write.written);
+                sqe->buf_index = _fixed_buffers ? static_cast<std::uint16_t>(index) : 0;
+                sqe->user_data = static_cast<std::uint64_t>(index);
+            }
+
+            void Reap() {
+                bool resubmit = false;
+                _ring->Reap([this, &resubmit](std::uint64_t user_data, int result) {
+                    int index = static_cast<int>(user_data);
+                    Write& write = _writes[index];
+                    if (result > 0) {
+                        write.written += static_cast<std::size_t>(result);
+                        if (write.written < write.size) {
+                            QueueWrite(index);
+                            resubmit = true;
+                            return;
+                        }
+                    }
+                    else if (!_error) {
+                        int code = result < 0 ? -result : EIO;
+                        _error = std::make_exception_ptr(std::system_error(code, std::generic_category(), "outman: direct write failed"));
+                    }
+                    write.in_flight = false;
+                });
+                if (resubmit) {
+                    _ring->Submit();
+                }
+            }
+#endif
+
+            const std::size_t _alignment;
+            const std::size_t _block_size;
+            bool _direct_io = false;
+            FileHandle _file;
+            AlignedBlock _blocks[2];
+            Write _writes[2];
+            int _current = 0;
+            // File offset of the current block's first byte, and bytes in it.
+            std::uint64_t _block_offset = 0;
+            std::size_t _used = 0;
+            std::exception_ptr _error;
+#if OUTMAN_HAS_IO_URING
+            std::unique_ptr<IoUring> _ring;
+            bool _fixed_buffers = false;
+#endif
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_DIRECT_FILE_WRITER_HPP
@@ -0,0 +1,272 @@
+#ifndef OUTMAN_DETAIL_FILE_HANDLE_HPP
+#define OUTMAN_DETAIL_FILE_HANDLE_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace outman {
+    namespace detail {
+        // One contiguous piece of a gathered write.
+        struct WriteChunk {
+            const void* data;
+            std::size_t size;
+        };
+
+        // Owning file descriptor, created if missing and opened write-only
+        // for appending unless `flags` says otherwise (O_RDWR to read back,
+        // 0 for positioned writes). Writes are retried until complete, so
+        // callers never see a short write; failures throw std::system_error.
+        class FileHandle {
+        public:
+            FileHandle() = default;
+
+            explicit FileHandle(const std::string& path, int flags = O_APPEND) {
+                int access = (flags & O_RDWR) ? 0 : O_WRONLY;
+#if defined(_WIN32)
+                _fd = ::_open(path.c_str(), access | _O_CREAT | _O_BINARY | flags, _S_IREAD | _S_IWRITE);
+#else
+                do {
+                    _fd = ::open(path.c_str(), access | O_CREAT | O_CLOEXEC | flags, 0644);
+                } while (_fd < 0 && errno == EINTR);
+#endif
+                if (_fd < 0) {
+                    throw std::system_error(errno, std::generic_category(), "outman: cannot open " + path);
+                }
+            }
+
+            ~FileHandle() {
+                Close();
+            }
+
+            FileHandle(FileHandle&& other) noexcept : _fd(std::exchange(other._fd, -1)) {}
+
+            FileHandle& operator=(FileHandle&& other) noexcept {
+                if (this != &other) {
+                    Close();
+                    _fd = std::exchange(other._fd, -1);
+                }
+                return *this;
+            }
+
+            FileHandle(const FileHandle&) = delete;
+            FileHandle& operator=(const FileHandle&) = delete;
+
+            bool IsOpen() const {
+                return _fd >= 0;
+            }
+
+            int Native() const {
+                return _fd;
+            }
+
+            void Write(const void* data, std::size_t size) {
+                const char* bytes = static_cast<const char*>(data);
+                while (size > 0) {
+#if defined(_WIN32)
+                    auto written = ::_write(_fd, bytes, static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30)));
+#else
+                    auto written = ::write(_fd, bytes, size);
+#endif
+                    if (written < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        throw std::system_error(errno, std::generic_category(), "outman: write failed");
+                    }
+                    bytes += written;
+                    size -= static_cast<std::size_t>(written);
+                }
+            }
+
+            // Writes at `offset` without moving the file position. Not for
+            // handles opened with O_APPEND, which append regardless.
+            void WriteAt(const void* data, std::size_t size, std::uint64_t offset) {
+                const char* bytes = static_cast<const char*>(data);
+                while (size > 0) {
+#if defined(_WIN32)
+                    if (::_lseeki64(_fd, static_cast<__int64>(offset), SEEK_SET) < 0) {
+                        throw std::system_error(errno, std::generic_category(), "outman: seek failed");
+                    }
+                    auto written = ::_write(_fd, bytes, static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30)));
+#else
+                    auto written = ::pwrite(_fd, bytes, size, static_cast<off_t>(offset));
+#endif
+                    if (written < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        throw std::system_error(errno, std::generic_category(), "outman: write failed");
+                    }
+                    bytes += written;
+                    size -= static_cast<std::size_t>(written);
+                    offset += static_cast<std::uint64_t>(written);
+                }
+            }
+
+            // Reads up to `size` bytes at `offset`; returns fewer only at the
+            // end of the file.
+            std::size_t ReadAt(void* data, std::size_t size, std::uint64_t offset) const {
+                char* bytes = static_cast<char*>(data);
+                std::size_t total = 0;
+                while (total < size) {
+#if defined(_WIN32)
+                    if (::_lseeki64(_fd, static_cast<__int64>(offset + total), SEEK_SET) < 0) {
+                        throw std::system_error(errno, std::generic_category(), "outman: seek failed");
+                    }
+                    auto result = ::_read(_fd, bytes + total, static_cast<unsigned>(std::min<std::size_t>(size - total, 1u << 30)));
+#else
+                    auto result = ::pread(_fd, bytes + total, size - total, static_cast<off_t>(offset + total));
+#endif
+                    if (result < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        throw std::system_error(errno, std::generic_category(), "outman: read failed");
+                    }
+                    if (result == 0) {
+                        break;
+                    }
+                    total += static_cast<std::size_t>(result);
+                }
+                return total;
+            }
+
+            void Truncate(std::uint64_t size) {
+#if defined(_WIN32)
+                int result = ::_chsize_s(_fd, static_cast<__int64>(size));
+                if (result != 0) {
+                    errno = result;
+                }
+#else
+                int result;
+                do {
+                    result = ::ftruncate(_fd, static_cast<off_t>(size));
+                } while (result != 0 && errno == EINTR);
+#endif
+                if (result != 0) {
+                    throw std::system_error(errno, std::generic_category(), "outman: truncate failed");
+                }
+            }
+
+            std::uint64_t Size() const {
+#if defined(_WIN32)
+                auto size = ::_filelengthi64(_fd);
+#else
+                struct stat status;
+                auto size = ::fstat(_fd, &status) == 0 ? static_cast<long long>(status.st_size) : -1;
+#endif
+                if (size < 0) {
+                    throw std::system_error(errno, std::generic_category(), "outman: stat failed");
+                }
+                return static_cast<std::uint64_t>(size);
+            }
+
+            // Writes all chunks in order with as few system calls as the
+            // platform allows (one writev per IOV_MAX chunks on POSIX).
+            void WriteV(const WriteChunk* chunks, std::size_t count) {
+#if defined(_WIN32)
+                for (std::size_t i = 0; i < count; ++i) {
+                    Write(chunks[i].data, chunks[i].size);
+                }
+#else
+                constexpr std::size_t kMaxChunks = 64;
+                static_assert(kMaxChunks <= IOV_MAX, "writev chunk limit");
+                iovec vectors[kMaxChunks];
+                while (count > 0) {
+                    std::size_t batch = 0;
+                    for (; batch < count && batch < kMaxChunks; ++batch) {
+                        vectors[batch].iov_base = const_cast<void*>(chunks[batch].data);
+                        vectors[batch].iov_len = chunks[batch].size;
+                    }
+                    WriteVectors(vectors, batch);
+                    chunks += batch;
+                    count -= batch;
+                }
+#endif
+            }
+
+            // Flushes written data to the device. With `data_only`, metadata
+            // that is not needed to read the data back (e.g. mtime) may stay
+            // behind (fdatasync).
+            void Sync(bool data_only = true) {
+#if defined(_WIN32)
+                (void)data_only;
+                if (::_commit(_fd) != 0) {
+                    throw std::system_error(errno, std::generic_category(), "outman: sync failed");
+                }
+#else
+                int result;
+                do {
+#if defined(__APPLE__)
+                    (void)data_only;
+                    result = ::fsync(_fd);
+#else
+                    result = data_only ? ::fdatasync(_fd) : ::fsync(_fd);
+#endif
+                } while (result != 0 && errno == EINTR);
+                if (result != 0) {
+                    throw std::system_error(errno, std::generic_category(), "outman: sync failed");
+                }
+#endif
+            }
+
+            void Close() {
+                if (_fd >= 0) {
+#if defined(_WIN32)
+                    ::_close(_fd);
+#else
+                    ::close(_fd);
+#endif
+                    _fd = -1;
+                }
+            }
+
+        private:
+#if !defined(_WIN32)
+            // Retries short writes from where the kernel stopped.
+            void WriteVectors(iovec* vectors, std::size_t count) {
+                while (count > 0) {
+                    auto written = ::writev(_fd, vectors, static_cast<int>(count));
+                    if (written < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        throw std::system_error(errno, std::generic_category(), "outman: writev failed");
+                    }
+                    auto left = static_cast<std::size_t>(written);
+                    while (count > 0 && left >= vectors->iov_len) {
+                        left -= vectors->iov_len;
+                        ++vectors;
+                        --count;
+                    }
+                    if (count > 0) {
+                        vectors->iov_base = static_cast<char*>(vectors->iov_base) + left;
+                        vectors->iov_len -= left;
+                    }
+                }
+            }
+#endif
+
+            int _fd = -1;
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_FILE_HANDLE_HPP
@@ -0,0 +1,176 @@
+#ifndef OUTMAN_DETAIL_FLUSH_CONTROLLER_HPP
+#define OUTMAN_DETAIL_FLUSH_CONTROLLER_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "../flush_policy.hpp"
+
+namespace outman {
+    namespace detail {
+        // Decides when a flushable slot flushes, following a FlushPolicy.
+        // Everything but Due runs in the slot's drain, one call at a time;
+        // Due is the flush timer's lock-free peek at the oldest record.
+        class FlushController {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+            explicit FlushController(const FlushPolicy& policy) : _policy(policy) {
+                if (Adaptive()) {
+                    _record_cap = _policy.max_records ? _policy.max_records : kDefaultRecordCap;
+                    _record_limit = std::min<std::size_t>(_record_cap, kAdaptiveStartRecords);
+                    _byte_limit = _policy.max_bytes;
+                    _age_limit = std::max(_policy.staleness_target / 2, std::chrono::milliseconds(1));
+                }
+                else {
+                    _record_limit = _policy.max_records;
+                    _byte_limit = _policy.max_bytes;
+                    _age_limit = _policy.max_age;
+                }
+                _due_age_ms.store(_age_limit.count(), std::memory_order_relaxed);
+            }
+
+            // Period at which the flush timer should call Due, or zero when
+            // no age limit applies.
+            std::chrono::milliseconds CheckInterval() const {
+                auto age = Adaptive() ? _policy.staleness_target : _policy.max_age;
+                return age.count() > 0 ? std::max(age / 4, std::chrono::milliseconds(1)) : std::chrono::milliseconds(0);
+            }
+
+            // `submitted` is when the producer saved the record.
+            void OnAdded(std::size_t bytes, Clock::time_point submitted) {
+                if (_records == 0) {
+                    _oldest = submitted;
+                    if (Adaptive()) {
+                        _oldest_added = Clock::now();
+                    }
+                    // At most one age flush per age limit: records that aged
+                    // out while queued behind a backlog are not flushed one
+                    // by one, which would only make the backlog grow.
+                    _age_start = std::max(submitted, _last_flush);
+                    _oldest_ns.store(_age_start.time_since_epoch().count(), std::memory_order_relaxed);
+                }
+                ++_records;
+                _bytes += bytes;
+            }
+
+            bool ShouldFlush(Clock::time_point now) const {
+                if (_records == 0) {
+                    return false;
+                }
+                if (_record_limit == 0 && _byte_limit == 0 && _age_limit.count() == 0) {
+                    return true;
+                }
+                return (_record_limit != 0 && _records >= _record_limit)
+                    || (_byte_limit != 0 && _bytes >= _byte_limit)
+                    || (_age_limit.count() != 0 && now - _age_start >= _age_limit);
+            }
+
+            // Any thread. True if the age trigger of ShouldFlush would fire.
+            bool Due(Clock::time_point now) const {
+                auto oldest_ns = _oldest_ns.load(std::memory_order_relaxed);
+                auto age_ms = _due_age_ms.load(std::memory_order_relaxed);
+                return oldest_ns != 0 && age_ms != 0
+                    && now - Clock::time_point(Clock::duration(oldest_ns)) >= std::chrono::milliseconds(age_ms);
+            }
+
+            void OnFlushed(Clock::time_point now) {
+                if (Adaptive() && _records != 0) {
+                    RecordStaleness(now - _oldest, now - _oldest_added);
+                }
+                _last_flush = now;
+                _records = 0;
+                _bytes = 0;
+                _oldest_ns.store(0, std::memory_order_relaxed);
+            }
+
+            std::size_t RecordLimit() const {
+                return _record_limit;
+            }
+
+            std::chrono::milliseconds AgeLimit() const {
+                return _age_limit;
+            }
+
+        private:
+            static constexpr std::size_t kSampleCount = 64;
+            static constexpr std::size_t kAdaptEvery = 32;
+            static constexpr std::size_t kAdaptiveStartRecords = 64;
+            static constexpr std::size_t kDefaultRecordCap = std::size_t(1) << 20;
+
+            bool Adaptive() const {
+                return _policy.staleness_target.count() > 0;
+            }
+
+            // `batched` is the part of `staleness` the record spent in the
+            // strategy's batch, the rest it waited to be drained.
+            void RecordStaleness(Clock::duration staleness, Clock::duration batched) {
+                _batched_samples[_sample_count % kSampleCount] = batched;
+                _samples[_sample_count++ % kSampleCount] = staleness;
+                if (_sample_count % kAdaptEvery == 0) {
+                    Adapt();
+                }
+            }
+
+            Clock::duration P99(const std::array<Clock::duration, kSampleCount>& samples) const {
+                std::size_t count = std::min(_sample_count, kSampleCount);
+                std::array<Clock::duration, kSampleCount> sorted;
+                std::copy_n(samples.begin(), count, sorted.begin());
+                std::size_t index = (count * 99 + 99) / 100 - 1;
+                std::nth_element(sorted.begin(), sorted.begin() + index, sorted.begin() + count);
+                return sorted[index];
+            }
+
+            // Shrinks batches when the p99 staleness misses the target and
+            // grows them while it stays well under. Smaller batches help only
+            // while batching is a fair share of the staleness; when records
+            // mostly wait to be drained, they would slow the drain down, so
+            // the thresholds hold.
+            void Adapt() {
+                auto p99 = P99(_samples);
+                auto target = _policy.staleness_target;
+                if (p99 > target) {
+                    if (P99(_batched_samples) <= target / 2) {
+                        return;
+                    }
+                    _record_limit = std::max<std::size_t>(_record_limit / 2, 1);
+                    _byte_limit = _byte_limit ? std::max<std::size_t>(_byte_limit / 2, 1) : 0;
+                    _age_limit = std::max(_age_limit * 3 / 4, std::chrono::milliseconds(1));
+                }
+                else if (p99 < target / 2) {
+                    _record_limit = std::min(_record_limit * 2, _record_cap);
+                    _byte_limit = _byte_limit ? std::min(_byte_limit * 2, _policy.max_bytes) : 0;
+                    _age_limit = std::min(_age_limit * 5 / 4 + std::chrono::milliseconds(1), target);
+                }
+                _due_age_ms.store(_age_limit.count(), std::memory_order_relaxed);
+            }
+
+            const FlushPolicy _policy;
+            std::size_t _record_limit = 0;
+            std::size_t _record_cap = 0;
+            std::size_t _byte_limit = 0;
+            std::chrono::milliseconds _age_limit{ 0 };
+
+            std::size_t _records = 0;
+            std::size_t _bytes = 0;
+            // Submission and arrival of the oldest unflushed record.
+            Clock::time_point _oldest;
+            Clock::time_point _oldest_added;
+            Clock::time_point _age_start;
+            Clock::time_point _last_flush;
+
+            std::array<Clock::duration, kSampleCount> _samples{};
+            std::array<Clock::duration, kSampleCount> _batched_samples{};
+            std::size_t _sample_count = 0;
+
+            std::atomic<Clock::rep> _oldest_ns{ 0 };
+            std::atomic<std::chrono::milliseconds::rep> _due_age_ms{ 0 };
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_FLUSH_CONTROLLER_HPP
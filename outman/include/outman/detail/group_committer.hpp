@@ -0,0 +1,162 @@
+#ifndef OUTMAN_DETAIL_GROUP_COMMITTER_HPP
+#define OUTMAN_DETAIL_GROUP_COMMITTER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "../sync_policy.hpp"
+#include "save_completion.hpp"
+
+namespace outman {
+    namespace detail {
+        // Group commit for one file sink. The sink reports the bytes it
+        // takes through Added and the manager parks completions with
+        // WhenCommitted; a commit writes out the sink's buffers, runs one
+        // sync for everything gathered so far and then releases all parked
+        // completions with its outcome. Records that arrive while a sync
+        // runs wait for the next one, which covers them all.
+        //
+        // `write_out` runs under the sink's mutex; `sync` runs outside it,
+        // so the sink keeps taking records during the sync.
+        class GroupCommitter {
+        public:
+            using Done = std::function<void(std::exception_ptr)>;
+
+            GroupCommitter(
+                const SyncPolicy& policy,
+                std::mutex& mutex,
+                std::function<void()> write_out,
+                std::function<void()> sync
+            )
+                : _policy(policy), _mutex(mutex), _write_out(std::move(write_out)), _sync(std::move(sync)) {}
+
+            GroupCommitter(const GroupCommitter&) = delete;
+            GroupCommitter& operator=(const GroupCommitter&) = delete;
+
+            const SyncPolicy& Policy() const {
+                return _policy;
+            }
+
+            // Bytes checks its wait limit four times per limit, so a record
+            // waits at most about a quarter longer than asked for.
+            std::chrono::milliseconds CheckInterval() const {
+                if (_policy.mode == SyncMode::Interval) {
+                    return _policy.interval;
+                }
+                if (_policy.mode == SyncMode::Bytes && _policy.interval.count() > 0) {
+                    return std::max(_policy.interval / 4, std::chrono::milliseconds(1));
+                }
+                return std::chrono::milliseconds(0);
+            }
+
+            // Caller holds the sink's mutex. Returns true once enough bytes
+            // arrived for a commit; the caller commits after unlocking.
+            bool Added(std::size_t bytes) {
+                if (_policy.mode == SyncMode::None) {
+                    return false;
+                }
+                MarkDirty();
+                _bytes += bytes;
+                return _policy.mode == SyncMode::Bytes && _bytes >= _policy.bytes;
+            }
+
+            void WhenCommitted(Done done) {
+                if (_policy.mode == SyncMode::None) {
+                    done(nullptr);
+                    return;
+                }
+                bool commit_now;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    MarkDirty();
+                    _waiters.push_back(std::move(done));
+                    commit_now = _policy.mode == SyncMode::EveryBatch
+                        || (_policy.mode == SyncMode::Bytes && _bytes >= _policy.bytes);
+                }
+                if (commit_now) {
+                    Commit();
+                }
+            }
+
+            void CommitIfDue(std::chrono::steady_clock::time_point now) {
+                bool due;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    due = _dirty && (_policy.mode == SyncMode::Interval
+                        || (_policy.mode == SyncMode::Bytes && now - _dirty_since >= _policy.interval));
+                }
+                if (due) {
+                    Commit();
+                }
+            }
+
+            // Never throws: the outcome goes to the released completions,
+            // or to std::cerr if nobody waited.
+            void Commit() {
+                // One commit at a time, so completions are released in order.
+                std::lock_guard<std::mutex> commit_lock(_commit_mutex);
+                std::vector<Done> waiters;
+                std::exception_ptr error;
+                bool dirty;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    dirty = std::exchange(_dirty, false);
+                    _bytes = 0;
+                    waiters.swap(_waiters);
+                    if (dirty) {
+                        try {
+                            _write_out();
+                        }
+                        catch (...) {
+                            error = std::current_exception();
+                        }
+                    }
+                }
+                if (dirty && !error) {
+                    try {
+                        _sync();
+                    }
+                    catch (...) {
+                        error = std::current_exception();
+                    }
+                }
+                if (error && waiters.empty()) {
+                    ReportSaveError(error);
+                }
+                for (auto& done : waiters) {
+                    done(error);
+                }
+            }
+
+        private:
+            void MarkDirty() {
+                if (!_dirty) {
+                    _dirty = true;
+                    if (_policy.mode == SyncMode::Bytes) {
+                        _dirty_since = std::chrono::steady_clock::now();
+                    }
+                }
+            }
+
+            const SyncPolicy _policy;
+            std::mutex& _mutex;
+            std::function<void()> _write_out;
+            std::function<void()> _sync;
+            std::mutex _commit_mutex;
+            // Guarded by _mutex: whether anything arrived since the last
+            // commit, since when, how many bytes, and who waits for it.
+            bool _dirty = false;
+            std::chrono::steady_clock::time_point _dirty_since;
+            std::size_t _bytes = 0;
+            std::vector<Done> _waiters;
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_GROUP_COMMITTER_HPP
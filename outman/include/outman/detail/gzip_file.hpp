@@ -0,0 +1,103 @@
+#ifndef OUTMAN_DETAIL_GZIP_FILE_HPP
+#define OUTMAN_DETAIL_GZIP_FILE_HPP
+
+// zlib is optional: define OUTMAN_WITH_ZLIB=1 and link zlib to get the
+// gzip helpers (the CMake target does both when it finds zlib).
+#if !defined(OUTMAN_WITH_ZLIB)
+#define OUTMAN_WITH_ZLIB 0
+#endif
+
+#if OUTMAN_WITH_ZLIB
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <zlib.h>
+
+#include "file_handle.hpp"
+
+namespace outman {
+    namespace detail {
+        // Appends `data` to `out` as one complete gzip member. Members can be
+        // concatenated: gzip, zcat and zlib's gzread read them as one stream.
+        inline void GzipBlock(const char* data, std::size_t size, std::string& out, int level) {
+            z_stream stream{};
+            if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                throw std::runtime_error("outman: cannot initialize zlib");
+            }
+            std::size_t start = out.size();
+            // The bound holds the whole member, so one call finishes it.
+            out.resize(start + deflateBound(&stream, static_cast<uLong>(size)));
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+            stream.avail_in = static_cast<uInt>(size);
+            stream.next_out = reinterpret_cast<Bytef*>(&out[start]);
+            stream.avail_out = static_cast<uInt>(out.size() - start);
+            int result = deflate(&stream, Z_FINISH);
+            out.resize(out.size() - stream.avail_out);
+            deflateEnd(&stream);
+            if (result != Z_STREAM_END) {
+                throw std::runtime_error("outman: zlib failed to compress a block");
+            }
+        }
+
+        // Compresses `source` into the gzip file `target`. The output is
+        // written under a temporary name and renamed once complete, so
+        // `target` never holds a partial file; only then is `source`
+        // removed. On failure `source` stays and the error is thrown.
+        inline void GzipFile(const std::string& source, const std::string& target, int level) {
+            constexpr std::size_t kChunk = std::size_t(1) << 20;
+            std::string partial = target + ".part";
+
+            z_stream stream{};
+            // 15 window bits plus 16 selects the gzip wrapper.
+            if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                throw std::runtime_error("outman: cannot initialize zlib");
+            }
+            try {
+                FileHandle in(source, O_RDWR);
+                FileHandle out(partial, O_TRUNC);
+                std::vector<char> input(kChunk);
+                std::vector<char> output(kChunk);
+                std::uint64_t offset = 0;
+                int flush = Z_NO_FLUSH;
+                while (flush != Z_FINISH) {
+                    std::size_t read = in.ReadAt(input.data(), input.size(), offset);
+                    offset += read;
+                    flush = read < input.size() ? Z_FINISH : Z_NO_FLUSH;
+                    stream.next_in = reinterpret_cast<Bytef*>(input.data());
+                    stream.avail_in = static_cast<uInt>(read);
+                    do {
+                        stream.next_out = reinterpret_cast<Bytef*>(output.data());
+                        stream.avail_out = static_cast<uInt>(output.size());
+                        if (deflate(&stream, flush) == Z_STREAM_ERROR) {
+                            throw std::runtime_error("outman: zlib failed on " + source);
+                        }
+                        out.Write(output.data(), output.size() - stream.avail_out);
+                    } while (stream.avail_out == 0);
+                }
+                deflateEnd(&stream);
+            }
+            catch (...) {
+                deflateEnd(&stream);
+                std::remove(partial.c_str());
+                throw;
+            }
+            if (std::rename(partial.c_str(), target.c_str()) != 0) {
+                int error = errno;
+                std::remove(partial.c_str());
+                throw std::system_error(error, std::generic_category(), "outman: cannot rename " + partial);
+            }
+            std::remove(source.c_str());
+        }
+    }
+}
+
+#endif  // OUTMAN_WITH_ZLIB
+
+#endif  // OUTMAN_DETAIL_GZIP_FILE_HPP
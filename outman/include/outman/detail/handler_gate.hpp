@@ -0,0 +1,77 @@
+#ifndef OUTMAN_DETAIL_HANDLER_GATE_HPP
+#define OUTMAN_DETAIL_HANDLER_GATE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace outman {
+    namespace detail {
+        // Guards handlers that capture their owner's `this` and are posted to
+        // an executor the owner does not control. A wrapped handler runs only
+        // while the gate is open; Close shuts it and waits for the wrapped
+        // handlers already running. Handlers still queued after that do
+        // nothing when the executor gets to them, as they only touch the
+        // shared state, not the owner. Copies share one gate.
+        //
+        // Close must not be called from a wrapped handler.
+        class HandlerGate {
+        public:
+            HandlerGate() : _state(std::make_shared<State>()) {}
+
+            template <typename TFn>
+            auto Wrap(TFn&& fn) const {
+                return [state = _state, fn = std::forward<TFn>(fn)](auto&&... args) mutable {
+                    if (!state->Enter()) {
+                        return;
+                    }
+                    struct Leave {
+                        State& state;
+                        ~Leave() {
+                            state.Leave();
+                        }
+                    } leave{ *state };
+                    fn(std::forward<decltype(args)>(args)...);
+                };
+            }
+
+            void Close() {
+                std::unique_lock<std::mutex> lock(_state->mutex);
+                _state->closed = true;
+                _state->idle.wait(lock, [this]() {
+                    return _state->running == 0;
+                });
+            }
+
+        private:
+            struct State {
+                bool Enter() {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (closed) {
+                        return false;
+                    }
+                    ++running;
+                    return true;
+                }
+
+                void Leave() {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (--running == 0 && closed) {
+                        idle.notify_all();
+                    }
+                }
+
+                std::mutex mutex;
+                std::condition_variable idle;
+                std::size_t running = 0;
+                bool closed = false;
+            };
+
+            std::shared_ptr<State> _state;
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_HANDLER_GATE_HPP
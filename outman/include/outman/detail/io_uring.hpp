@@ -0,0 +1,222 @@
+#ifndef OUTMAN_DETAIL_IO_URING_HPP
+#define OUTMAN_DETAIL_IO_URING_HPP
+
+// io_uring is driven through its raw system calls, so no liburing is
+// needed; only the kernel UAPI header. Without it OUTMAN_HAS_IO_URING is
+// 0 and file sinks use blocking writes.
+#if !defined(OUTMAN_HAS_IO_URING)
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define OUTMAN_HAS_IO_URING 1
+#endif
+#endif
+#endif
+#if !defined(OUTMAN_HAS_IO_URING)
+#define OUTMAN_HAS_IO_URING 0
+#endif
+
+#if OUTMAN_HAS_IO_URING
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace outman {
+    namespace detail {
+        // Submission and completion rings of one io_uring instance. Not
+        // thread-safe: the owner serializes every call.
+        class IoUring {
+        public:
+            // Throws std::system_error if the kernel has no io_uring or
+            // refuses it (e.g. disabled by sysctl or a seccomp filter).
+            explicit IoUring(unsigned entries) {
+                io_uring_params params{};
+                _fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+                if (_fd < 0) {
+                    throw std::system_error(errno, std::generic_category(), "outman: io_uring_setup failed");
+                }
+                try {
+                    Map(params);
+                }
+                catch (...) {
+                    Unmap();
+                    ::close(_fd);
+                    throw;
+                }
+            }
+
+            ~IoUring() {
+                Unmap();
+                ::close(_fd);
+            }
+
+            IoUring(const IoUring&) = delete;
+            IoUring& operator=(const IoUring&) = delete;
+
+            // Pins `count` buffers for IORING_OP_WRITE_FIXED; they are
+            // addressed by their index from then on.
+            void RegisterBuffers(const iovec* buffers, unsigned count) {
+                Register(IORING_REGISTER_BUFFERS, buffers, count, "outman: cannot register io_uring buffers");
+            }
+
+            // Registers descriptors for IOSQE_FIXED_FILE, addressed by index.
+            void RegisterFiles(const int* fds, unsigned count) {
+                Register(IORING_REGISTER_FILES, fds, count, "outman: cannot register io_uring files");
+            }
+
+            // Next free submission entry, zeroed, or nullptr if the ring is full.
+            io_uring_sqe* NextSqe() {
+                unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+                if (_sqe_tail - head >= _sq_entries) {
+                    return nullptr;
+                }
+                unsigned index = _sqe_tail & _sq_mask;
+                io_uring_sqe* sqe = &_sqes[index];
+                std::memset(sqe, 0, sizeof(*sqe));
+                _sq_array[index] = index;
+                ++_sqe_tail;
+                return sqe;
+            }
+
+            // Hands every entry taken since the last call to the kernel in
+            // one system call, and waits for at least `wait_for` completions.
+            void Submit(unsigned wait_for = 0) {
+                __atomic_store_n(_sq_tail, _sqe_tail, __ATOMIC_RELEASE);
+                unsigned to_submit = _sqe_tail - _submitted_tail;
+                if (to_submit == 0 && wait_for == 0) {
+                    return;
+                }
+                for (;;) {
+                    unsigned flags = wait_for ? IORING_ENTER_GETEVENTS : 0;
+                    long result = ::syscall(__NR_io_uring_enter, _fd, to_submit, wait_for, flags, nullptr, 0);
+                    if (result >= 0) {
+                        _submitted_tail += static_cast<unsigned>(result);
+                        to_submit -= static_cast<unsigned>(result);
+                        if (to_submit == 0) {
+                            return;
+                        }
+                        continue;
+                    }
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    // EAGAIN/EBUSY: the kernel is out of resources for the
+                    // moment. The entries stay queued for the next Submit,
+                    // once the caller reaped some completions.
+                    if (errno == EAGAIN || errno == EBUSY) {
+                        return;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "outman: io_uring_enter failed");
+                }
+            }
+
+            // Calls fn(user_data, result) for every completion posted so far,
+            // without a system call. Returns how many there were.
+            template <typename TFn>
+            unsigned Reap(TFn&& fn) {
+                unsigned head = *_cq_head;
+                unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+                unsigned count = 0;
+                for (; head != tail; ++head, ++count) {
+                    const io_uring_cqe& cqe = _cqes[head & _cq_mask];
+                    fn(cqe.user_data, cqe.res);
+                }
+                __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+                return count;
+            }
+
+        private:
+            void Map(const io_uring_params& params) {
+                _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+                if (single_mmap) {
+                    _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+                }
+
+                _sq_ring = MapRegion(_sq_ring_size, IORING_OFF_SQ_RING);
+                _cq_ring = single_mmap ? _sq_ring : MapRegion(_cq_ring_size, IORING_OFF_CQ_RING);
+                _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+                _sqes = static_cast<io_uring_sqe*>(MapRegion(_sqes_size, IORING_OFF_SQES));
+
+                char* sq = static_cast<char*>(_sq_ring);
+                _sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+                _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+                _sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+                _sq_entries = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+                _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+                _sqe_tail = _submitted_tail = *_sq_tail;
+
+                char* cq = static_cast<char*>(_cq_ring);
+                _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+                _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+                _cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+                _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            }
+
+            void* MapRegion(std::size_t size, off_t offset) {
+                void* region = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, offset);
+                if (region == MAP_FAILED) {
+                    throw std::system_error(errno, std::generic_category(), "outman: cannot map io_uring");
+                }
+                return region;
+            }
+
+            void Unmap() {
+                if (_sqes) {
+                    ::munmap(_sqes, _sqes_size);
+                }
+                if (_cq_ring && _cq_ring != _sq_ring) {
+                    ::munmap(_cq_ring, _cq_ring_size);
+                }
+                if (_sq_ring) {
+                    ::munmap(_sq_ring, _sq_ring_size);
+                }
+                _sqes = nullptr;
+                _sq_ring = _cq_ring = nullptr;
+            }
+
+            void Register(unsigned opcode, const void* arg, unsigned count, const char* what) {
+                if (::syscall(__NR_io_uring_register, _fd, opcode, arg, count) < 0) {
+                    throw std::system_error(errno, std::generic_category(), what);
+                }
+            }
+
+            int _fd = -1;
+
+            void* _sq_ring = nullptr;
+            void* _cq_ring = nullptr;
+            std::size_t _sq_ring_size = 0;
+            std::size_t _cq_ring_size = 0;
+            io_uring_sqe* _sqes = nullptr;
+            std::size_t _sqes_size = 0;
+
+            unsigned* _sq_head = nullptr;
+            unsigned* _sq_tail = nullptr;
+            unsigned* _sq_array = nullptr;
+            unsigned _sq_mask = 0;
+            unsigned _sq_entries = 0;
+            // Entries taken by NextSqe, and entries the kernel accepted.
+            unsigned _sqe_tail = 0;
+            unsigned _submitted_tail = 0;
+
+            unsigned* _cq_head = nullptr;
+            unsigned* _cq_tail = nullptr;
+            unsigned _cq_mask = 0;
+            io_uring_cqe* _cqes = nullptr;
+        };
+    }
+}
+
+#endif  // OUTMAN_HAS_IO_URING
+
+#endif  // OUTMAN_DETAIL_IO_URING_HPP
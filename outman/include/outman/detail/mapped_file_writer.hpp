@@ -0,0 +1,182 @@
+#ifndef OUTMAN_DETAIL_MAPPED_FILE_WRITER_HPP
+#define OUTMAN_DETAIL_MAPPED_FILE_WRITER_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "file_handle.hpp"
+
+namespace outman {
+    // What a mapped file sink does to persist its window on flush and when
+    // it moves the window on.
+    enum class MapSyncPolicy {
+        // Leave write-back to the kernel; no msync at all.
+        Kernel,
+        // msync(MS_ASYNC): start write-back without waiting.
+        Async,
+        // msync(MS_SYNC): wait until the data is on the device.
+        Sync
+    };
+
+    namespace detail {
+        // Appends to a file through a sliding shared mapping. The file is
+        // extended with fallocate one window ahead, so writing a record is
+        // a memcpy into the mapping with no system call; only moving the
+        // window on costs a munmap, fallocate and mmap. Allocating the
+        // blocks up front matters: writing into a hole of a mapped file on
+        // a full disk would raise SIGBUS instead of an error.
+        //
+        // Until Close the file is longer than its data and the end reads as
+        // zeros; Close (and the destructor) truncate it to the bytes written.
+        // A file that already has data is continued after it.
+        //
+        // POSIX only. Not thread-safe.
+        class MappedFileWriter {
+        public:
+            MappedFileWriter(const std::string& path, std::size_t window_size, MapSyncPolicy sync_policy)
+                : _file(path, O_RDWR), _sync_policy(sync_policy) {
+                _page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+                _window_size = std::max(RoundUp(window_size, _page_size), 2 * _page_size);
+                _size = _synced = _file.Size();
+                MapWindowAt(_size);
+            }
+
+            ~MappedFileWriter() {
+                try {
+                    Close();
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "outman: mapped file close failed: " << e.what() << std::endl;
+                }
+            }
+
+            MappedFileWriter(const MappedFileWriter&) = delete;
+            MappedFileWriter& operator=(const MappedFileWriter&) = delete;
+
+            // Contiguous room for `size` bytes at the end of the data, or
+            // nullptr if a record that large has to go through Append. The
+            // bytes count as written once Commit(size) is called.
+            char* Reserve(std::size_t size) {
+                if (size > _window_size / 2) {
+                    return nullptr;
+                }
+                if (_size + size > _window_offset + _window_size) {
+                    MapWindowAt(_size);
+                }
+                return _window + (_size - _window_offset);
+            }
+
+            void Commit(std::size_t size) {
+                _size += size;
+            }
+
+            void Append(const char* data, std::size_t size) {
+                while (size > 0) {
+                    if (_size == _window_offset + _window_size) {
+                        MapWindowAt(_size);
+                    }
+                    std::size_t chunk = std::min<std::size_t>(size, _window_offset + _window_size - _size);
+                    std::memcpy(_window + (_size - _window_offset), data, chunk);
+                    _size += chunk;
+                    data += chunk;
+                    size -= chunk;
+                }
+            }
+
+            // Applies the sync policy to what was written since the last call.
+            void Flush() {
+                if (_sync_policy == MapSyncPolicy::Kernel || _size == _synced) {
+                    return;
+                }
+                std::uint64_t from = std::max<std::uint64_t>(_synced, _window_offset) / _page_size * _page_size;
+                char* begin = _window + (from - _window_offset);
+                Sync(begin, static_cast<std::size_t>(_size - from));
+                _synced = _size;
+            }
+
+            void Close() {
+                if (!_window) {
+                    return;
+                }
+                Flush();
+                Unmap();
+                _file.Truncate(_size);
+                if (_sync_policy == MapSyncPolicy::Sync) {
+                    _file.Sync(false);
+                }
+            }
+
+            std::uint64_t Size() const {
+                return _size;
+            }
+
+        private:
+            static std::size_t RoundUp(std::size_t value, std::size_t alignment) {
+                return (value + alignment - 1) / alignment * alignment;
+            }
+
+            // Maps a window starting at the page that holds `offset`, after
+            // retiring the current one.
+            void MapWindowAt(std::uint64_t offset) {
+                if (_window) {
+                    Flush();
+                    Unmap();
+                }
+                std::uint64_t window_offset = offset / _page_size * _page_size;
+                std::uint64_t end = window_offset + _window_size;
+                if (_file.Size() < end) {
+                    int error = ::posix_fallocate(_file.Native(), static_cast<off_t>(window_offset), static_cast<off_t>(_window_size));
+                    // Some file systems cannot preallocate; fall back to a
+                    // sparse extension.
+                    if (error == EOPNOTSUPP || error == EINVAL) {
+                        _file.Truncate(end);
+                    }
+                    else if (error != 0) {
+                        throw std::system_error(error, std::generic_category(), "outman: cannot extend mapped file");
+                    }
+                }
+                void* window = ::mmap(nullptr, _window_size, PROT_READ | PROT_WRITE, MAP_SHARED, _file.Native(), static_cast<off_t>(window_offset));
+                if (window == MAP_FAILED) {
+                    throw std::system_error(errno, std::generic_category(), "outman: cannot map file window");
+                }
+                ::madvise(window, _window_size, MADV_SEQUENTIAL);
+                _window = static_cast<char*>(window);
+                _window_offset = window_offset;
+            }
+
+            void Sync(char* begin, std::size_t size) {
+                int flags = _sync_policy == MapSyncPolicy::Sync ? MS_SYNC : MS_ASYNC;
+                if (size > 0 && ::msync(begin, size, flags) != 0) {
+                    throw std::system_error(errno, std::generic_category(), "outman: msync failed");
+                }
+            }
+
+            void Unmap() {
+                ::munmap(_window, _window_size);
+                _window = nullptr;
+            }
+
+            FileHandle _file;
+            const MapSyncPolicy _sync_policy;
+            std::size_t _page_size = 4096;
+            std::size_t _window_size = 0;
+            char* _window = nullptr;
+            std::uint64_t _window_offset = 0;
+            // Bytes of data in the file, and how far Flush has synced.
+            std::uint64_t _size = 0;
+            std::uint64_t _synced = 0;
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_MAPPED_FILE_WRITER_HPP
@@ -0,0 +1,130 @@
+#ifndef OUTMAN_DETAIL_MPSC_RING_HPP
+#define OUTMAN_DETAIL_MPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace outman {
+    namespace detail {
+        constexpr std::size_t kCacheLineSize = 64;
+
+        // Bounded multi-producer single-consumer ring with pre-allocated,
+        // cache-line padded cells. Each cell carries a sequence number that
+        // tells producers and the consumer whose turn it is, so a push costs
+        // one CAS on the tail plus one release store, and a pop touches no
+        // shared counter at all.
+        template <typename T>
+        class MpscRing {
+        public:
+            explicit MpscRing(std::size_t capacity)
+                : _capacity(RoundUpToPowerOfTwo(capacity < 2 ? 2 : capacity)),
+                _mask(_capacity - 1),
+                _cells(new Cell[_capacity]) {
+                for (std::size_t i = 0; i < _capacity; ++i) {
+                    _cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            MpscRing(const MpscRing&) = delete;
+            MpscRing& operator=(const MpscRing&) = delete;
+
+            // Any thread. Returns false if the ring is full.
+            bool TryPush(T&& value) {
+                std::size_t pos = _tail.load(std::memory_order_relaxed);
+                Cell* cell;
+                for (;;) {
+                    cell = &_cells[pos & _mask];
+                    std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                    auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+                    if (diff == 0) {
+                        if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    }
+                    else if (diff < 0) {
+                        return false;
+                    }
+                    else {
+                        pos = _tail.load(std::memory_order_relaxed);
+                    }
+                }
+                cell->value = std::move(value);
+                cell->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Consumer only. Hands up to `max_items` items to `fn` in FIFO
+            // order and returns how many were consumed.
+            template <typename TFn>
+            std::size_t DrainBatch(TFn&& fn, std::size_t max_items) {
+                std::size_t count = 0;
+                while (count < max_items) {
+                    Cell& cell = _cells[_head & _mask];
+                    if (cell.sequence.load(std::memory_order_acquire) != _head + 1) {
+                        break;
+                    }
+                    fn(std::move(cell.value));
+                    cell.value = T();
+                    cell.sequence.store(_head + _capacity, std::memory_order_release);
+                    ++_head;
+                    ++count;
+                }
+                _head_snapshot.store(_head, std::memory_order_relaxed);
+                return count;
+            }
+
+            // Consumer only. True if the next cell holds a published item.
+            bool HasPending() const {
+                return IsPublished(_head);
+            }
+
+            // Consumer only. Position of the next item to consume.
+            std::size_t HeadPosition() const {
+                return _head;
+            }
+
+            // Any thread. True if the item at `position` is published and not
+            // consumed yet.
+            bool IsPublished(std::size_t position) const {
+                const Cell& cell = _cells[position & _mask];
+                return cell.sequence.load(std::memory_order_acquire) == position + 1;
+            }
+
+            // Approximate, for statistics.
+            std::size_t ApproximateSize() const {
+                std::size_t tail = _tail.load(std::memory_order_relaxed);
+                std::size_t head = _head_snapshot.load(std::memory_order_relaxed);
+                return tail > head ? tail - head : 0;
+            }
+
+            std::size_t Capacity() const {
+                return _capacity;
+            }
+
+        private:
+            struct alignas(kCacheLineSize) Cell {
+                std::atomic<std::size_t> sequence;
+                T value;
+            };
+
+            static std::size_t RoundUpToPowerOfTwo(std::size_t value) {
+                std::size_t result = 1;
+                while (result < value) {
+                    result <<= 1;
+                }
+                return result;
+            }
+
+            const std::size_t _capacity;
+            const std::size_t _mask;
+            std::unique_ptr<Cell[]> _cells;
+
+            alignas(kCacheLineSize) std::atomic<std::size_t> _tail{ 0 };
+            alignas(kCacheLineSize) std::size_t _head = 0;
+            std::atomic<std::size_t> _head_snapshot{ 0 };
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_MPSC_RING_HPP
@@ -0,0 +1,102 @@
+#ifndef OUTMAN_DETAIL_PRIORITY_SCHEDULER_HPP
+#define OUTMAN_DETAIL_PRIORITY_SCHEDULER_HPP
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/post.hpp>
+
+#include "../priority.hpp"
+#include "handler_gate.hpp"
+
+namespace outman {
+    namespace detail {
+        // Weighted scheduling of strategy drain tasks on top of the manager's
+        // executor. Scheduled tasks wait in one lane per priority class, and
+        // every Schedule posts one anonymous runner to the executor. A runner
+        // does not run "its" task: it picks a lane by smooth weighted
+        // round-robin when it gets a worker, so the executor's FIFO order
+        // never decides who goes first, and every busy lane is picked at
+        // least once per round of `sum(weights)` picks.
+        class PriorityScheduler {
+        public:
+            using Task = std::function<void()>;
+
+            // Runners go through `gate`, so none touches the scheduler once
+            // the gate is closed.
+            PriorityScheduler(boost::asio::any_io_executor executor, const PriorityWeights& weights, HandlerGate gate)
+                : _executor(std::move(executor)), _gate(std::move(gate)) {
+                for (std::size_t i = 0; i < kPriorityCount; ++i) {
+                    _lanes[i].weight = weights[i] == 0 ? 1 : static_cast<long long>(weights[i]);
+                }
+            }
+
+            void Schedule(OutputPriority priority, Task task) {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _lanes[static_cast<std::size_t>(priority)].tasks.push_back(std::move(task));
+                }
+                boost::asio::post(_executor, _gate.Wrap([this]() {
+                    RunNext();
+                }));
+            }
+
+        private:
+            struct Lane {
+                std::deque<Task> tasks;
+                long long weight = 1;
+                long long credit = 0;
+            };
+
+            void RunNext() {
+                Task task;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    Lane* chosen = PickLocked();
+                    if (!chosen) {
+                        return;
+                    }
+                    task = std::move(chosen->tasks.front());
+                    chosen->tasks.pop_front();
+                    if (chosen->tasks.empty()) {
+                        // An idle lane does not bank credit or debt.
+                        chosen->credit = 0;
+                    }
+                }
+                task();
+            }
+
+            // Smooth weighted round-robin over the non-empty lanes; ties go to
+            // the higher priority.
+            Lane* PickLocked() {
+                Lane* chosen = nullptr;
+                long long total = 0;
+                for (std::size_t i = kPriorityCount; i-- > 0;) {
+                    Lane& lane = _lanes[i];
+                    if (lane.tasks.empty()) {
+                        continue;
+                    }
+                    lane.credit += lane.weight;
+                    total += lane.weight;
+                    if (!chosen || lane.credit > chosen->credit) {
+                        chosen = &lane;
+                    }
+                }
+                if (chosen) {
+                    chosen->credit -= total;
+                }
+                return chosen;
+            }
+
+            boost::asio::any_io_executor _executor;
+            HandlerGate _gate;
+            std::mutex _mutex;
+            std::array<Lane, kPriorityCount> _lanes;
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_PRIORITY_SCHEDULER_HPP
@@ -0,0 +1,206 @@
+#ifndef OUTMAN_DETAIL_PRODUCER_BATCHER_HPP
+#define OUTMAN_DETAIL_PRODUCER_BATCHER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "../channel_options.hpp"
+#include "record_queue.hpp"
+
+namespace outman {
+    namespace detail {
+        class ProducerBatcherBase {
+        public:
+            virtual ~ProducerBatcherBase() = default;
+
+            // Hands off every thread buffer whose oldest record is older than
+            // the batch age.
+            virtual void Sweep(std::chrono::steady_clock::time_point now) = 0;
+
+            // Hands off every thread buffer regardless of age.
+            virtual void FlushAll() = 0;
+
+            // Detaches the batcher from its manager; later hand-offs are dropped.
+            virtual void Close() = 0;
+
+            virtual std::chrono::milliseconds BatchAge() const = 0;
+        };
+
+        // Thread-local producer batching for one channel. Each producer thread
+        // appends to its own buffer, and the buffer is handed to the manager
+        // as one batch when it reaches batch_size, when the manager's flush
+        // timer finds it older than batch_age, or when the thread exits.
+        //
+        // The per-thread buffer has a mutex only so the timer sweep can take
+        // it; the owning thread is the only regular user, so the lock stays in
+        // that thread's cache and there is no cross-core traffic per record.
+        //
+        // A hand-off from a producer thread may wait for room in the manager's
+        // queues, as a direct SaveAsync would. The timer sweep must not wait:
+        // the hand-off takes what fits and the rest stays in the buffer, still
+        // ahead of the thread's later records, for the next sweep.
+        template <typename TData>
+        class ProducerBatcher
+            : public ProducerBatcherBase,
+            public std::enable_shared_from_this<ProducerBatcher<TData>> {
+        public:
+            using Batch = std::vector<QueuedRecord<TData>>;
+            // Takes the records from the front of the batch, all of them when
+            // `may_block`, and returns how many it took.
+            using HandoffFn = std::function<std::size_t(const Batch& batch, bool may_block)>;
+
+            ProducerBatcher(const ChannelOptions& options, HandoffFn handoff)
+                : _id(NextId()),
+                _batch_size(std::max<std::size_t>(options.batch_size, 1)),
+                _batch_age(options.batch_age),
+                _handoff(std::move(handoff)) {}
+
+            void Append(QueuedRecord<TData>&& record) {
+                ThreadBuffer& buffer = LocalBuffer();
+                std::unique_lock<std::mutex> lock(buffer.mutex);
+                if (buffer.records.empty()) {
+                    buffer.records.reserve(_batch_size);
+                    buffer.first_record_time = record.submitted;
+                }
+                buffer.records.push_back(std::move(record));
+                if (buffer.records.size() >= _batch_size) {
+                    HandOffLocked(buffer, true);
+                }
+            }
+
+            void Sweep(std::chrono::steady_clock::time_point now) override {
+                for (const auto& buffer : Buffers()) {
+                    std::unique_lock<std::mutex> lock(buffer->mutex, std::try_to_lock);
+                    // A busy producer hands its buffer off by itself soon enough.
+                    if (lock.owns_lock() && !buffer->records.empty() && now - buffer->first_record_time >= _batch_age) {
+                        HandOffLocked(*buffer, false);
+                    }
+                }
+            }
+
+            void FlushAll() override {
+                for (const auto& buffer : Buffers()) {
+                    std::lock_guard<std::mutex> lock(buffer->mutex);
+                    if (!buffer->records.empty()) {
+                        HandOffLocked(*buffer, true);
+                    }
+                }
+            }
+
+            void Close() override {
+                std::unique_lock<std::shared_mutex> lock(_handoff_mutex);
+                _handoff = nullptr;
+            }
+
+            std::chrono::milliseconds BatchAge() const override {
+                return _batch_age;
+            }
+
+        private:
+            struct ThreadBuffer {
+                std::mutex mutex;
+                Batch records;
+                std::chrono::steady_clock::time_point first_record_time;
+            };
+
+            struct ThreadEntry {
+                std::uint64_t batcher_id;
+                std::shared_ptr<ThreadBuffer> buffer;
+                std::weak_ptr<ProducerBatcher> owner;
+            };
+
+            // The calling thread's buffers, one per batcher it produced into.
+            // Destroyed at thread exit, which hands the leftovers off.
+            struct ThreadTable {
+                std::vector<ThreadEntry> entries;
+
+                ~ThreadTable() {
+                    for (auto& entry : entries) {
+                        if (auto owner = entry.owner.lock()) {
+                            owner->Retire(entry.buffer);
+                        }
+                    }
+                }
+            };
+
+            static std::uint64_t NextId() {
+                static std::atomic<std::uint64_t> next_id{ 1 };
+                return next_id.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            ThreadBuffer& LocalBuffer() {
+                static thread_local ThreadTable table;
+                for (auto& entry : table.entries) {
+                    if (entry.batcher_id == _id) {
+                        return *entry.buffer;
+                    }
+                }
+
+                auto buffer = std::make_shared<ThreadBuffer>();
+                {
+                    std::lock_guard<std::mutex> lock(_buffers_mutex);
+                    _buffers.push_back(buffer);
+                }
+                table.entries.push_back({ _id, buffer, this->weak_from_this() });
+                return *buffer;
+            }
+
+            void Retire(const std::shared_ptr<ThreadBuffer>& buffer) {
+                {
+                    std::lock_guard<std::mutex> lock(_buffers_mutex);
+                    _buffers.erase(std::remove(_buffers.begin(), _buffers.end(), buffer), _buffers.end());
+                }
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+                if (!buffer->records.empty()) {
+                    HandOffLocked(*buffer, true);
+                }
+            }
+
+            std::vector<std::shared_ptr<ThreadBuffer>> Buffers() {
+                std::lock_guard<std::mutex> lock(_buffers_mutex);
+                return _buffers;
+            }
+
+            // Caller holds buffer.mutex, so batches of one thread are handed
+            // off in order even when the timer sweep races the producer.
+            // Hand-offs of different threads run side by side; a sweep skips
+            // the buffer rather than wait for Close.
+            void HandOffLocked(ThreadBuffer& buffer, bool may_block) {
+                std::shared_lock<std::shared_mutex> lock(_handoff_mutex, std::defer_lock);
+                if (may_block) {
+                    lock.lock();
+                }
+                else if (!lock.try_lock()) {
+                    return;
+                }
+
+                std::size_t taken = _handoff ? _handoff(buffer.records, may_block) : buffer.records.size();
+                if (taken >= buffer.records.size()) {
+                    buffer.records = Batch();
+                }
+                else {
+                    buffer.records.erase(buffer.records.begin(), buffer.records.begin() + taken);
+                }
+            }
+
+            const std::uint64_t _id;
+            const std::size_t _batch_size;
+            const std::chrono::milliseconds _batch_age;
+
+            std::mutex _buffers_mutex;
+            std::vector<std::shared_ptr<ThreadBuffer>> _buffers;
+
+            std::shared_mutex _handoff_mutex;
+            HandoffFn _handoff;
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_PRODUCER_BATCHER_HPP
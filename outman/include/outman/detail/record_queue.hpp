@@ -0,0 +1,275 @@
+#ifndef OUTMAN_DETAIL_RECORD_QUEUE_HPP
+#define OUTMAN_DETAIL_RECORD_QUEUE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <mutex>
+#include <vector>
+
+#include "../backpressure.hpp"
+#include "../data/shared_payload.hpp"
+#include "../sender_id.hpp"
+#include "save_completion.hpp"
+
+namespace outman {
+    namespace detail {
+        template <typename TData>
+        struct QueuedRecord {
+            SharedPayload<TData> payload;
+            SenderId sender;
+            // Set when the caller asked to be told the record was saved.
+            std::shared_ptr<SaveCompletion> completion;
+            // When the producer saved it; flush policies age records from
+            // here, so time spent queued counts.
+            std::chrono::steady_clock::time_point submitted;
+        };
+
+        struct PushOutcome {
+            bool accepted;
+            // The queue went from idle to busy: the caller must post a drain.
+            bool schedule_drain;
+        };
+
+        // Pending records of one strategy, bounded according to QueueLimits.
+        // A single drain task at a time consumes the queue; it is scheduled by
+        // the producer that finds the queue idle, so a busy sink costs one
+        // post per batch instead of one per record.
+        template <typename TData>
+        class RecordQueue {
+        public:
+            explicit RecordQueue(const QueueLimits& limits) : _limits(limits) {
+                if (_limits.keep_every == 0) {
+                    _limits.keep_every = 1;
+                }
+            }
+
+            PushOutcome Push(QueuedRecord<TData>&& record, bool may_block) {
+                std::unique_lock<std::mutex> lock(_mutex);
+                bool accepted = PushLocked(std::move(record), may_block, lock);
+                return { accepted, accepted && ScheduleDrainLocked() };
+            }
+
+            // Queues the records from `next` on under a single lock acquisition,
+            // never blocking, and advances `next` past those it took. A full
+            // Block queue stops there, leaving the rest for the caller to push
+            // once there is room, unless `overfill` has it take them beyond its
+            // capacity. `accepted` is set if at least one record got in.
+            PushOutcome PushBatch(const std::vector<QueuedRecord<TData>>& records, std::size_t& next, bool overfill) {
+                std::unique_lock<std::mutex> lock(_mutex);
+                bool accepted = false;
+                for (; next < records.size(); ++next) {
+                    if (_limits.policy == BackpressurePolicy::Block && IsFull()) {
+                        if (!overfill) {
+                            break;
+                        }
+                        _records.push_back(records[next]);
+                        ++_stats.accepted;
+                        accepted = true;
+                        continue;
+                    }
+                    accepted |= PushLocked(QueuedRecord<TData>(records[next]), false, lock);
+                }
+                return { accepted, accepted && ScheduleDrainLocked() };
+            }
+
+            // Schedules a drain with no new record, e.g. so a flush policy can
+            // act. Returns true if the caller must post it.
+            bool RequestDrain() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return ScheduleDrainLocked();
+            }
+
+            // Asks the drain task for a flush: after its current batch, or with
+            // `after_queued` only once every record queued so far has been
+            // dispatched (records queued later never hold it up). Returns true
+            // if the caller must post the drain.
+            bool RequestFlush(bool after_queued) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (after_queued) {
+                    _flush_ahead = _records.size();
+                }
+                else if (!_flush_requested) {
+                    _flush_ahead = 0;
+                }
+                _flush_requested = true;
+                return ScheduleDrainLocked();
+            }
+
+            // Drain task only. True, once, when a flush was requested and the
+            // records queued before the request are gone.
+            bool TakeFlushRequest() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_flush_requested || _flush_ahead > 0) {
+                    return false;
+                }
+                _flush_requested = false;
+                return true;
+            }
+
+            // Drain task only. Moves up to `max_records` records into `batch`.
+            void PopBatch(std::vector<QueuedRecord<TData>>& batch, std::size_t max_records) {
+                std::function<void()> room_waiter;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    while (!_records.empty() && batch.size() < max_records) {
+                        batch.push_back(std::move(_records.front()));
+                        PopFrontLocked();
+                    }
+                    if (_waiters > 0) {
+                        _not_full.notify_all();
+                    }
+                    if (_room_waiter && !IsFull()) {
+                        room_waiter = std::exchange(_room_waiter, nullptr);
+                    }
+                }
+                if (room_waiter) {
+                    room_waiter();
+                }
+            }
+
+            // Records a Block queue takes before it is full; unlimited for the
+            // other policies, which never refuse a record for lack of room.
+            std::size_t Room() const {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_limits.policy != BackpressurePolicy::Block || _limits.capacity == 0) {
+                    return std::numeric_limits<std::size_t>::max();
+                }
+                return _records.size() < _limits.capacity ? _limits.capacity - _records.size() : 0;
+            }
+
+            // Calls `fn` once the queue is no longer full: right away if it is
+            // not, otherwise from the drain that makes room. One waiter at a
+            // time; a new one replaces the previous.
+            void WhenRoom(std::function<void()> fn) {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (IsFull()) {
+                        _room_waiter = std::move(fn);
+                        return;
+                    }
+                }
+                fn();
+            }
+
+            // Drain task only, once the popped batch has been dispatched.
+            // Returns true when records or a flush request remain, in which
+            // case the drain stays scheduled; otherwise the queue goes idle and
+            // the next Push schedules a new drain. Going idle only after
+            // dispatching keeps two drains of one queue from ever running at once.
+            bool FinishDrain() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _drain_scheduled = !_records.empty() || _flush_requested;
+                return _drain_scheduled;
+            }
+
+            // No records queued and no drain in flight (a requested flush
+            // keeps its drain scheduled until it ran).
+            bool Idle() const {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _records.empty() && !_drain_scheduled;
+            }
+
+            BackpressureStats Stats() const {
+                std::lock_guard<std::mutex> lock(_mutex);
+                BackpressureStats stats = _stats;
+                stats.queued = _records.size();
+                return stats;
+            }
+
+        private:
+            bool PushLocked(QueuedRecord<TData>&& record, bool may_block, std::unique_lock<std::mutex>& lock) {
+                if (IsFull()) {
+                    switch (_limits.policy) {
+                    case BackpressurePolicy::Block:
+                        if (!may_block) {
+                            ++_stats.rejected;
+                            Discard(record);
+                            return false;
+                        }
+                        ++_stats.blocked;
+                        ++_waiters;
+                        _not_full.wait(lock, [this]() { return !IsFull(); });
+                        --_waiters;
+                        break;
+                    case BackpressurePolicy::FailFast:
+                        ++_stats.rejected;
+                        Discard(record);
+                        return false;
+                    case BackpressurePolicy::DropNewest:
+                        ++_stats.dropped_newest;
+                        Discard(record);
+                        return false;
+                    case BackpressurePolicy::DropOldest:
+                        Discard(_records.front());
+                        PopFrontLocked();
+                        ++_stats.dropped_oldest;
+                        break;
+                    case BackpressurePolicy::KeepEveryNth:
+                        if (++_sample_counter % _limits.keep_every != 0) {
+                            ++_stats.sampled_out;
+                            Discard(record);
+                            return false;
+                        }
+                        Discard(_records.front());
+                        PopFrontLocked();
+                        ++_stats.dropped_oldest;
+                        break;
+                    }
+                }
+                else {
+                    _sample_counter = 0;
+                }
+
+                _records.push_back(std::move(record));
+                ++_stats.accepted;
+                return true;
+            }
+
+            // The record will not reach the strategy; tell whoever waits on it.
+            void Discard(const QueuedRecord<TData>& record) const {
+                if (record.completion) {
+                    record.completion->Done(std::make_exception_ptr(RecordDroppedError(_limits.policy)));
+                }
+            }
+
+            void PopFrontLocked() {
+                _records.pop_front();
+                if (_flush_ahead > 0) {
+                    --_flush_ahead;
+                }
+            }
+
+            bool ScheduleDrainLocked() {
+                bool schedule_drain = !_drain_scheduled;
+                _drain_scheduled = true;
+                return schedule_drain;
+            }
+
+            bool IsFull() const {
+                return _limits.capacity != 0 && _records.size() >= _limits.capacity;
+            }
+
+            QueueLimits _limits;
+            mutable std::mutex _mutex;
+            std::condition_variable _not_full;
+            std::function<void()> _room_waiter;
+            std::deque<QueuedRecord<TData>> _records;
+            BackpressureStats _stats;
+            std::size_t _sample_counter = 0;
+            std::size_t _waiters = 0;
+            bool _drain_scheduled = false;
+            bool _flush_requested = false;
+            // Records still ahead of the requested flush.
+            std::size_t _flush_ahead = 0;
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_RECORD_QUEUE_HPP
@@ -0,0 +1,102 @@
+#ifndef OUTMAN_DETAIL_RING_INGESTION_HPP
+#define OUTMAN_DETAIL_RING_INGESTION_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "../backpressure.hpp"
+#include "../channel_options.hpp"
+#include "mpsc_ring.hpp"
+#include "record_queue.hpp"
+
+namespace outman {
+    namespace detail {
+        // Front-end of a channel in IngestionMode::Ring. Producers publish into
+        // the ring; the producer that finds the consumer idle schedules one
+        // drain task, which keeps draining batches until the ring is empty.
+        template <typename TData>
+        class RingIngestion {
+        public:
+            explicit RingIngestion(const ChannelOptions& options)
+                : _ring(options.ring_capacity),
+                _drain_batch(std::max<std::size_t>(options.drain_batch, 1)) {}
+
+            PushOutcome Push(QueuedRecord<TData>&& record, bool may_block) {
+                if (!_ring.TryPush(std::move(record))) {
+                    if (!may_block) {
+                        _rejected.fetch_add(1, std::memory_order_relaxed);
+                        return { false, false };
+                    }
+                    _blocked.fetch_add(1, std::memory_order_relaxed);
+                    do {
+                        std::this_thread::yield();
+                    } while (!_ring.TryPush(std::move(record)));
+                }
+
+                // Pairs with the fence in ContinueDrain: either we see the drain
+                // going idle, or the drain sees our record.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                bool schedule_drain = !_drain_scheduled.load(std::memory_order_relaxed)
+                    && !_drain_scheduled.exchange(true, std::memory_order_acq_rel);
+                return { true, schedule_drain };
+            }
+
+            // Drain task only. Moves up to `max_records` records, and at most
+            // one batch, into `batch`.
+            void PopBatch(std::vector<QueuedRecord<TData>>& batch, std::size_t max_records) {
+                _ring.DrainBatch([&batch](QueuedRecord<TData>&& record) {
+                    batch.push_back(std::move(record));
+                }, std::min(max_records, _drain_batch));
+            }
+
+            // Drain task only, once the popped batch has been handed on.
+            // Returns true if the drain must run again; otherwise the drain is
+            // idle and the next producer schedules a new one. Handing the batch
+            // on before going idle keeps a new drain from overtaking it.
+            bool ContinueDrain() {
+                if (_ring.HasPending()) {
+                    return true;
+                }
+
+                // Once the flag is cleared another drain may own the consumer
+                // side, so the head is read before.
+                std::size_t head = _ring.HeadPosition();
+                _drain_scheduled.store(false, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                // A record published after the check above may have seen the
+                // flag still set; take the drain back in that case.
+                return _ring.IsPublished(head) && !_drain_scheduled.exchange(true, std::memory_order_acq_rel);
+            }
+
+            std::size_t DrainBatchSize() const {
+                return _drain_batch;
+            }
+
+            // No drain scheduled, hence nothing published that is not fanned
+            // out. A drain waiting for room in a strategy queue stays scheduled.
+            bool Idle() const {
+                return !_drain_scheduled.load(std::memory_order_acquire);
+            }
+
+            // Accepted records are not counted so producers stay at a few
+            // atomics per record.
+            BackpressureStats Stats() const {
+                BackpressureStats stats;
+                stats.blocked = _blocked.load(std::memory_order_relaxed);
+                stats.rejected = _rejected.load(std::memory_order_relaxed);
+                stats.queued = _ring.ApproximateSize();
+                return stats;
+            }
+
+        private:
+            MpscRing<QueuedRecord<TData>> _ring;
+            const std::size_t _drain_batch;
+            alignas(kCacheLineSize) std::atomic<bool> _drain_scheduled{ false };
+            alignas(kCacheLineSize) std::atomic<std::uint64_t> _blocked{ 0 };
+            std::atomic<std::uint64_t> _rejected{ 0 };
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_RING_INGESTION_HPP
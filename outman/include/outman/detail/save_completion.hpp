@@ -0,0 +1,162 @@
+#ifndef OUTMAN_DETAIL_SAVE_COMPLETION_HPP
+#define OUTMAN_DETAIL_SAVE_COMPLETION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/post.hpp>
+
+namespace outman {
+    namespace detail {
+        inline void ReportSaveError(const std::exception_ptr& error) {
+            try {
+                std::rethrow_exception(error);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+            }
+            catch (...) {
+                std::cerr << "Unknown error occurred" << std::endl;
+            }
+        }
+
+        // Shared by every queued copy of one record. It starts with one
+        // reference held by the submitter; AddPending adds one per strategy
+        // the record is handed to, and each Done drops one. The last Done
+        // finishes the save with the first error reported, if any.
+        class SaveCompletion {
+        public:
+            virtual ~SaveCompletion() = default;
+
+            void AddPending(std::size_t count) {
+                _remaining.fetch_add(count, std::memory_order_relaxed);
+            }
+
+            void Done(std::exception_ptr error = nullptr) {
+                if (error) {
+                    std::lock_guard<std::mutex> lock(_error_mutex);
+                    if (!_error) {
+                        _error = std::move(error);
+                    }
+                }
+                if (_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::exception_ptr first_error;
+                    {
+                        std::lock_guard<std::mutex> lock(_error_mutex);
+                        first_error = std::move(_error);
+                    }
+                    Finish(std::move(first_error));
+                }
+            }
+
+        protected:
+            virtual void Finish(std::exception_ptr error) = 0;
+
+        private:
+            std::atomic<std::size_t> _remaining{ 1 };
+            std::mutex _error_mutex;
+            std::exception_ptr _error;
+        };
+
+        // Completes an asio completion handler on its associated executor
+        // (the manager's executor by default), never inline.
+        template <typename THandler>
+        class HandlerCompletion : public SaveCompletion {
+        public:
+            HandlerCompletion(THandler&& handler, const boost::asio::any_io_executor& fallback)
+                : _work(boost::asio::get_associated_executor(handler, fallback)),
+                _handler(std::move(handler)) {}
+
+        protected:
+            void Finish(std::exception_ptr error) override {
+                auto executor = _work.get_executor();
+                boost::asio::post(executor, [handler = std::move(_handler), error = std::move(error)]() mutable {
+                    handler(std::move(error));
+                });
+                _work.reset();
+            }
+
+        private:
+            boost::asio::executor_work_guard<boost::asio::associated_executor_t<THandler, boost::asio::any_io_executor>> _work;
+            THandler _handler;
+        };
+
+        // Sequence numbers of tracked saves and the durability watermark: the
+        // highest sequence at or below which every tracked save has finished.
+        class CompletionTracker {
+        public:
+            std::uint64_t Begin() {
+                return _next.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void Complete(std::uint64_t sequence) {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (sequence != _watermark + 1) {
+                        _finished_ahead.insert(sequence);
+                        return;
+                    }
+                    _watermark = sequence;
+                    // Saves finished out of order close the gap they were waiting on.
+                    auto it = _finished_ahead.begin();
+                    while (it != _finished_ahead.end() && *it == _watermark + 1) {
+                        _watermark = *it;
+                        it = _finished_ahead.erase(it);
+                    }
+                }
+                _advanced.notify_all();
+            }
+
+            std::uint64_t Watermark() const {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _watermark;
+            }
+
+            bool WaitFor(std::uint64_t sequence, std::chrono::steady_clock::duration timeout) {
+                std::unique_lock<std::mutex> lock(_mutex);
+                return _advanced.wait_for(lock, timeout, [this, sequence]() {
+                    return _watermark >= sequence;
+                });
+            }
+
+        private:
+            std::atomic<std::uint64_t> _next{ 1 };
+            mutable std::mutex _mutex;
+            std::condition_variable _advanced;
+            std::uint64_t _watermark = 0;
+            std::set<std::uint64_t> _finished_ahead;
+        };
+
+        class TrackedCompletion : public SaveCompletion {
+        public:
+            TrackedCompletion(CompletionTracker& tracker, std::uint64_t sequence)
+                : _tracker(tracker), _sequence(sequence) {}
+
+        protected:
+            // Failures still advance the watermark; there is no caller to hand
+            // them to, so they go to std::cerr like untracked failures.
+            void Finish(std::exception_ptr error) override {
+                if (error) {
+                    ReportSaveError(error);
+                }
+                _tracker.Complete(_sequence);
+            }
+
+        private:
+            CompletionTracker& _tracker;
+            const std::uint64_t _sequence;
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_SAVE_COMPLETION_HPP
@@ -0,0 +1,148 @@
+#ifndef OUTMAN_DETAIL_STRATEGY_SLOT_HPP
+#define OUTMAN_DETAIL_STRATEGY_SLOT_HPP
+
+#include <memory>
+#include <optional>
+
+#include "../flush_policy.hpp"
+#include "../priority.hpp"
+#include "../strategies/group_commit_strategy.hpp"
+#include "../strategies/isaving_strategy.hpp"
+#include "flush_controller.hpp"
+#include "record_queue.hpp"
+
+namespace outman {
+    namespace detail {
+        enum class StrategyKind {
+            Sync,
+            WrappedSync,
+            Async,
+            Flushable
+        };
+
+        // A registered strategy with its interface resolved once, at
+        // AddStrategy time. Dispatching a record is then a single call through
+        // a pre-bound function pointer: no RTTI and no refcount traffic.
+        //
+        // Every slot is a serial execution lane: its queue lets only one drain
+        // task run at a time, so records reach the strategy one at a time and
+        // in submission order, while different slots still run in parallel on
+        // the manager's workers. Records wait in the slot's bounded queue until
+        // a drain task of the slot's priority class gets a worker.
+        template <typename TData>
+        class StrategySlot {
+        public:
+            // With a flush policy, a flushable strategy gets AddAsync per record
+            // and FlushAsync only when the slot's FlushController says so.
+            StrategySlot(
+                std::shared_ptr<ISavingStrategy<TData>> strategy,
+                const QueueLimits& limits,
+                OutputPriority priority,
+                const std::optional<FlushPolicy>& flush_policy = std::nullopt
+            )
+                : _strategy(std::move(strategy)), _queue(limits), _priority(priority),
+                _committer(dynamic_cast<IGroupCommitStrategy*>(_strategy.get())) {
+                // A wrapped-sync strategy only wraps Save to get off the
+                // caller's thread, which the lane already does: its Save runs
+                // here, in order, and the record is done once Save returns.
+                if (dynamic_cast<IWrappedSyncSavingStrategy<TData>*>(_strategy.get())) {
+                    Bind<ISavingStrategy<TData>, &DispatchSave>(_strategy.get(), StrategyKind::WrappedSync);
+                }
+                else if (auto* async = dynamic_cast<IAsyncSavingStrategy<TData>*>(_strategy.get())) {
+                    Bind<IAsyncSavingStrategy<TData>, &DispatchSaveAsync>(async, StrategyKind::Async);
+                }
+                else if (auto* flushable = dynamic_cast<IFlushableSavingStrategy<TData>*>(_strategy.get())) {
+                    if (flush_policy) {
+                        _flush_controller = std::make_unique<FlushController>(*flush_policy);
+                        Bind<IFlushableSavingStrategy<TData>, &DispatchAdd>(flushable, StrategyKind::Flushable);
+                    }
+                    else {
+                        Bind<IFlushableSavingStrategy<TData>, &DispatchAddFlush>(flushable, StrategyKind::Flushable);
+                    }
+                }
+                else {
+                    Bind<ISavingStrategy<TData>, &DispatchSave>(_strategy.get(), StrategyKind::Sync);
+                }
+            }
+
+            void Dispatch(const TData& data, SenderId sender) const {
+                _dispatch(_target, data, sender);
+            }
+
+            // Flushable strategies only.
+            void Flush() const {
+                static_cast<IFlushableSavingStrategy<TData>*>(_target)->FlushAsync(SenderId::Manager());
+            }
+
+            // Set for flushable strategies registered with a FlushPolicy.
+            FlushController* GetFlushController() const {
+                return _flush_controller.get();
+            }
+
+            // Set for strategies that complete records only once committed.
+            IGroupCommitStrategy* Committer() const {
+                return _committer;
+            }
+
+            StrategyKind Kind() const {
+                return _kind;
+            }
+
+            const std::shared_ptr<ISavingStrategy<TData>>& Strategy() const {
+                return _strategy;
+            }
+
+            OutputPriority Priority() const {
+                return _priority;
+            }
+
+            RecordQueue<TData>& Queue() {
+                return _queue;
+            }
+
+            const RecordQueue<TData>& Queue() const {
+                return _queue;
+            }
+
+        private:
+            using DispatchFn = void (*)(void*, const TData&, SenderId);
+
+            template <typename TInterface, DispatchFn Fn>
+            void Bind(TInterface* target, StrategyKind kind) {
+                // Stored as the exact interface pointer, cast back in Fn.
+                _target = static_cast<void*>(target);
+                _dispatch = Fn;
+                _kind = kind;
+            }
+
+            static void DispatchSaveAsync(void* target, const TData& data, SenderId sender) {
+                static_cast<IAsyncSavingStrategy<TData>*>(target)->SaveAsync(data, sender);
+            }
+
+            static void DispatchAdd(void* target, const TData& data, SenderId sender) {
+                static_cast<IFlushableSavingStrategy<TData>*>(target)->AddAsync(data, sender);
+            }
+
+            static void DispatchAddFlush(void* target, const TData& data, SenderId sender) {
+                auto* flushable = static_cast<IFlushableSavingStrategy<TData>*>(target);
+                flushable->AddAsync(data, sender);
+                flushable->FlushAsync(sender);
+            }
+
+            static void DispatchSave(void* target, const TData& data, SenderId sender) {
+                static_cast<ISavingStrategy<TData>*>(target)->Save(data, sender);
+            }
+
+            std::shared_ptr<ISavingStrategy<TData>> _strategy;
+            RecordQueue<TData> _queue;
+            const OutputPriority _priority;
+            std::unique_ptr<FlushController> _flush_controller;
+            IGroupCommitStrategy* const _committer;
+            void* _target = nullptr;
+            DispatchFn _dispatch = nullptr;
+            StrategyKind _kind = StrategyKind::Sync;
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_STRATEGY_SLOT_HPP
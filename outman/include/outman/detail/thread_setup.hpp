@@ -0,0 +1,72 @@
+#ifndef OUTMAN_DETAIL_THREAD_SETUP_HPP
+#define OUTMAN_DETAIL_THREAD_SETUP_HPP
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "../output_manager_config.hpp"
+
+namespace outman {
+    namespace detail {
+        // Applies name, affinity and scheduling settings to the calling thread.
+        // Failures are reported but never fatal: the worker still runs.
+        inline void ApplyThreadSettings(
+            const std::string& name,
+            const std::vector<int>& cpus,
+            SchedulingPolicy policy,
+            int priority
+        ) {
+#if defined(__linux__)
+            pthread_t self = pthread_self();
+
+            // Linux limits thread names to 15 characters plus the terminator.
+            std::string short_name = name.substr(0, 15);
+            pthread_setname_np(self, short_name.c_str());
+
+            if (!cpus.empty()) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (int cpu : cpus) {
+                    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                        CPU_SET(cpu, &set);
+                    }
+                }
+                if (int err = pthread_setaffinity_np(self, sizeof(set), &set)) {
+                    std::cerr << "outman: cannot set affinity of " << name << ": " << std::strerror(err) << std::endl;
+                }
+            }
+
+            if (policy != SchedulingPolicy::Default) {
+                int native_policy = SCHED_OTHER;
+                switch (policy) {
+                case SchedulingPolicy::Fifo: native_policy = SCHED_FIFO; break;
+                case SchedulingPolicy::RoundRobin: native_policy = SCHED_RR; break;
+                case SchedulingPolicy::Batch: native_policy = SCHED_BATCH; break;
+                case SchedulingPolicy::Idle: native_policy = SCHED_IDLE; break;
+                default: break;
+                }
+                sched_param param{};
+                param.sched_priority = priority;
+                if (int err = pthread_setschedparam(self, native_policy, &param)) {
+                    std::cerr << "outman: cannot set scheduling policy of " << name << ": " << std::strerror(err) << std::endl;
+                }
+            }
+#else
+            // Thread naming, pinning and policies are only wired up on Linux.
+            (void)name;
+            (void)cpus;
+            (void)policy;
+            (void)priority;
+#endif
+        }
+    }
+}
+
+#endif  // OUTMAN_DETAIL_THREAD_SETUP_HPP
@@ -0,0 +1,301 @@
+#ifndef OUTMAN_DETAIL_URING_FILE_WRITER_HPP
+#define OUTMAN_DETAIL_URING_FILE_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "file_handle.hpp"
+#include "io_uring.hpp"
+
+namespace outman {
+    namespace detail {
+        // Writes filled buffers to the end of one file without blocking the
+        // caller. With io_uring, every buffer is registered with the ring
+        // and the file is a fixed file, so a write is one submission entry
+        // that the kernel runs on its own; up to `buffer_count` writes are
+        // in flight at explicit offsets, and completions are read from the
+        // shared ring without a system call whenever the writer is used.
+        //
+        // If io_uring is not compiled in or the kernel refuses it, buffers
+        // are written with pwrite on the calling thread instead, which is
+        // what the manager's workers did before.
+        //
+        // Not thread-safe; write failures are thrown by the next call.
+        class UringFileWriter {
+        public:
+            UringFileWriter(const std::string& path, std::size_t buffer_size, std::size_t buffer_count)
+                : _file(path, 0), _buffer_size(buffer_size), _offset(_file.Size()) {
+#if OUTMAN_HAS_IO_URING
+                try {
+                    _ring = std::make_unique<IoUring>(static_cast<unsigned>(buffer_count));
+                }
+                catch (const std::system_error&) {
+                    _ring.reset();
+                }
+#endif
+                _buffers.resize(UsesIoUring() ? buffer_count : 1);
+                for (std::size_t i = 0; i < _buffers.size(); ++i) {
+                    _buffers[i].data.reserve(_buffer_size);
+                    _free.push_back(_buffers.size() - 1 - i);
+                }
+#if OUTMAN_HAS_IO_URING
+                if (_ring) {
+                    RegisterWithRing();
+                }
+#endif
+            }
+
+            ~UringFileWriter() {
+                try {
+                    if (_current != kNone && !_buffers[_current].data.empty()) {
+                        SubmitCurrent();
+                    }
+                    Drain();
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "outman: file write failed: " << e.what() << std::endl;
+                }
+            }
+
+            UringFileWriter(const UringFileWriter&) = delete;
+            UringFileWriter& operator=(const UringFileWriter&) = delete;
+
+            bool UsesIoUring() const {
+#if OUTMAN_HAS_IO_URING
+                return _ring != nullptr;
+#else
+                return false;
+#endif
+            }
+
+            std::size_t BufferSize() const {
+                return _buffer_size;
+            }
+
+            // The buffer to append records to. Waits for a write to finish
+            // if every buffer is in flight.
+            std::string& Current() {
+                if (_current == kNone) {
+                    ReapCompleted();
+                    while (_free.empty()) {
+                        WaitForCompletion();
+                    }
+                    _current = _free.back();
+                    _free.pop_back();
+                }
+                ThrowIfFailed();
+                return _buffers[_current].data;
+            }
+
+            bool HasPendingData() const {
+                return _current != kNone && !_buffers[_current].data.empty();
+            }
+
+            // Starts writing the current buffer at the end of the file.
+            void SubmitCurrent() {
+                if (_current == kNone) {
+                    return;
+                }
+                std::size_t index = _current;
+                _current = kNone;
+                Buffer& buffer = _buffers[index];
+                buffer.offset = _offset;
+                buffer.written = 0;
+                _offset += buffer.data.size();
+                if (buffer.data.empty()) {
+                    _free.push_back(index);
+                    return;
+                }
+#if OUTMAN_HAS_IO_URING
+                if (_ring) {
+                    ++_in_flight;
+                    if (StartWrite(index)) {
+                        _ring->Submit();
+                    }
+                    else {
+                        --_in_flight;
+                        Recycle(index);
+                    }
+                    ThrowIfFailed();
+                    return;
+                }
+#endif
+                try {
+                    _file.WriteAt(buffer.data.data(), buffer.data.size(), buffer.offset);
+                }
+                catch (...) {
+                    Recycle(index);
+                    throw;
+                }
+                Recycle(index);
+            }
+
+            // Waits until every submitted write finished.
+            void Drain() {
+                while (_in_flight > 0) {
+                    WaitForCompletion();
+                }
+                ThrowIfFailed();
+            }
+
+            FileHandle& File() {
+                return _file;
+            }
+
+        private:
+            static constexpr std::size_t kNone = static_cast<std::size_t>(-1);
+
+            struct Buffer {
+                std::string data;
+                std::uint64_t offset = 0;
+                std::size_t written = 0;
+                // Address the buffer was registered at; a buffer that grew
+                // past its capacity moved and is written without WRITE_FIXED.
+                const char* registered = nullptr;
+            };
+
+            void ThrowIfFailed() {
+                if (_error) {
+                    std::rethrow_exception(std::exchange(_error, nullptr));
+                }
+            }
+
+            // Back to the free list, shrunk again if a huge record grew it.
+            void Recycle(std::size_t index) {
+                Buffer& buffer = _buffers[index];
+                buffer.data.clear();
+                if (buffer.data.capacity() > 2 * _buffer_size) {
+                    std::string fresh;
+                    fresh.reserve(_buffer_size);
+                    buffer.data.swap(fresh);
+                }
+                _free.push_back(index);
+            }
+
+#if OUTMAN_HAS_IO_URING
+            // Registration failures (e.g. RLIMIT_MEMLOCK) only cost the
+            // fixed variants; the ring still works with plain writes.
+            void RegisterWithRing() {
+                std::vector<iovec> vectors(_buffers.size());
+                for (std::size_t i = 0; i < _buffers.size(); ++i) {
+                    vectors[i].iov_base = _buffers[i].data.data();
+                    vectors[i].iov_len = _buffers[i].data.capacity();
+                }
+                try {
+                    _ring->RegisterBuffers(vectors.data(), static_cast<unsigned>(vectors.size()));
+                    for (auto& buffer : _buffers) {
+                        buffer.registered = buffer.data.data();
+                    }
+                }
+                catch (const std::system_error&) {
+                }
+                try {
+                    int fd = _file.Native();
+                    _ring->RegisterFiles(&fd, 1);
+                    _fixed_file = true;
+                }
+                catch (const std::system_error&) {
+                }
+            }
+
+            // Queues the rest of the buffer. At most one entry per buffer is
+            // outstanding and the ring has one per buffer, but should it be
+            // full anyway the rest is written with pwrite right here, as
+            // reaping to make room may not nest in a completion; returns
+            // false then, with a failure kept for ThrowIfFailed.
+            bool StartWrite(std::size_t index) {
+                Buffer& buffer = _buffers[index];
+                io_uring_sqe* sqe = _ring->NextSqe();
+                if (!sqe) {
+                    try {
+                        _file.WriteAt(buffer.data.data() + buffer.written, buffer.data.size() - buffer.written, buffer.offset + buffer.written);
+                        buffer.written = buffer.data.size();
+                    }
+                    catch (...) {
+                        if (!_error) {
+                            _error = std::current_exception();
+                        }
+                    }
+                    return false;
+                }
+                const char* data = buffer.data.data() + buffer.written;
+                bool fixed = buffer.registered == buffer.data.data();
+                sqe->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+                sqe->fd = _fixed_file ? 0 : _file.Native();
+                sqe->flags = _fixed_file ? IOSQE_FIXED_FILE : 0;
+                sqe->off = buffer.offset + buffer.written;
+                sqe->addr = reinterpret_cast<std::uint64_t>(data);
+                sqe->len = static_cast<std::uint32_t>(buffer.data.size() - buffer.written);
+                sqe->buf_index = fixed ? static_cast<std::uint16_t>(index) : 0;
+                sqe->user_data = index;
+                return true;
+            }
+
+            void ReapCompleted() {
+                if (!_ring) {
+                    return;
+                }
+                bool resubmit = false;
+                _ring->Reap([this, &resubmit](std::uint64_t user_data, int result) {
+                    resubmit |= OnCompleted(static_cast<std::size_t>(user_data), result);
+                });
+                if (resubmit) {
+                    _ring->Submit();
+                }
+            }
+
+            // Returns true if the rest of a short write was queued.
+            bool OnCompleted(std::size_t index, int result) {
+                Buffer& buffer = _buffers[index];
+                if (result > 0) {
+                    buffer.written += static_cast<std::size_t>(result);
+                    if (buffer.written < buffer.data.size() && StartWrite(index)) {
+                        return true;
+                    }
+                }
+                else if (!_error) {
+                    int code = result < 0 ? -result : EIO;
+                    _error = std::make_exception_ptr(std::system_error(code, std::generic_category(), "outman: io_uring write failed"));
+                }
+                --_in_flight;
+                Recycle(index);
+                return false;
+            }
+#else
+            void ReapCompleted() {}
+#endif
+
+            void WaitForCompletion() {
+#if OUTMAN_HAS_IO_URING
+                if (_ring && _in_flight > 0) {
+                    _ring->Submit(1);
+                    ReapCompleted();
+                }
+#endif
+            }
+
+            FileHandle _file;
+            const std::size_t _buffer_size;
+            std::vector<Buffer> _buffers;
+            std::vector<std::size_t> _free;
+            std::size_t _current = kNone;
+            std::size_t _in_flight = 0;
+            // End of the data handed to SubmitCurrent so far.
+            std::uint64_t _offset;
+            std::exception_ptr _error;
+#if OUTMAN_HAS_IO_URING
+            std::unique_ptr<IoUring> _ring;
+            bool _fixed_file = false;
+#endif
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_URING_FILE_WRITER_HPP
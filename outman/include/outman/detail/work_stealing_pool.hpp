@@ -0,0 +1,247 @@
+#ifndef OUTMAN_DETAIL_WORK_STEALING_POOL_HPP
+#define OUTMAN_DETAIL_WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <boost/asio/execution.hpp>
+#include <boost/asio/execution_context.hpp>
+
+#include "mpsc_ring.hpp"
+
+namespace outman {
+    namespace detail {
+        // Move-only type-erased task; asio handlers are frequently move-only.
+        class PoolTask {
+        public:
+            PoolTask() = default;
+
+            template <typename TFn, typename = std::enable_if_t<!std::is_same_v<std::decay_t<TFn>, PoolTask>>>
+            explicit PoolTask(TFn&& fn) : _impl(new Impl<std::decay_t<TFn>>(std::forward<TFn>(fn))) {}
+
+            void operator()() {
+                _impl->Run();
+            }
+
+        private:
+            struct ImplBase {
+                virtual ~ImplBase() = default;
+                virtual void Run() = 0;
+            };
+
+            template <typename TFn>
+            struct Impl : ImplBase {
+                explicit Impl(TFn&& fn) : fn(std::move(fn)) {}
+                explicit Impl(const TFn& fn) : fn(fn) {}
+                void Run() override { fn(); }
+                TFn fn;
+            };
+
+            std::unique_ptr<ImplBase> _impl;
+        };
+
+        // Work-stealing alternative to the shared io_context. Every worker owns
+        // a deque: tasks submitted from a worker go to the back of its own
+        // deque and are taken back LIFO while they are still cache-hot, idle
+        // workers steal the oldest task from the front of a randomly chosen
+        // victim, and tasks from outside threads are spread round-robin.
+        //
+        // The pool is an asio execution_context with a matching executor, so
+        // strands, timers and any_io_executor work on top of it unchanged.
+        class WorkStealingPool : public boost::asio::execution_context {
+        public:
+            class executor_type {
+            public:
+                explicit executor_type(WorkStealingPool& pool) noexcept : _pool(&pool) {}
+
+                template <typename TFn>
+                void execute(TFn&& fn) const {
+                    _pool->Submit(PoolTask(std::forward<TFn>(fn)));
+                }
+
+                WorkStealingPool& query(boost::asio::execution::context_t) const noexcept {
+                    return *_pool;
+                }
+
+                static constexpr boost::asio::execution::blocking_t query(boost::asio::execution::blocking_t) noexcept {
+                    return boost::asio::execution::blocking.never;
+                }
+
+                executor_type require(boost::asio::execution::blocking_t::never_t) const noexcept {
+                    return *this;
+                }
+
+                friend bool operator==(const executor_type& a, const executor_type& b) noexcept {
+                    return a._pool == b._pool;
+                }
+
+                friend bool operator!=(const executor_type& a, const executor_type& b) noexcept {
+                    return a._pool != b._pool;
+                }
+
+            private:
+                WorkStealingPool* _pool;
+            };
+
+            // `on_thread_start` runs first on every worker with its index.
+            WorkStealingPool(std::size_t worker_count, std::function<void(std::size_t)> on_thread_start)
+                : _queues(worker_count < 1 ? 1 : worker_count) {
+                for (auto& queue : _queues) {
+                    queue = std::make_unique<WorkerQueue>();
+                }
+                _threads.reserve(_queues.size());
+                for (std::size_t i = 0; i < _queues.size(); ++i) {
+                    _threads.emplace_back([this, i, on_thread_start]() {
+                        if (on_thread_start) {
+                            on_thread_start(i);
+                        }
+                        Run(i);
+                    });
+                }
+            }
+
+            ~WorkStealingPool() {
+                Stop();
+                shutdown();
+                // Pending tasks may own strands of this context; release them
+                // while the services still exist.
+                for (auto& queue : _queues) {
+                    std::deque<PoolTask> tasks;
+                    {
+                        std::lock_guard<std::mutex> lock(queue->mutex);
+                        tasks.swap(queue->tasks);
+                    }
+                }
+                destroy();
+            }
+
+            executor_type get_executor() noexcept {
+                return executor_type(*this);
+            }
+
+            // Stops the workers after their current task and joins them.
+            // Queued tasks are not run.
+            void Stop() {
+                {
+                    std::lock_guard<std::mutex> lock(_sleep_mutex);
+                    _stopped = true;
+                }
+                _wake.notify_all();
+                for (auto& thread : _threads) {
+                    if (thread.joinable() && thread.get_id() != std::this_thread::get_id()) {
+                        thread.join();
+                    }
+                }
+            }
+
+        private:
+            struct alignas(kCacheLineSize) WorkerQueue {
+                std::mutex mutex;
+                std::deque<PoolTask> tasks;
+            };
+
+            struct WorkerContext {
+                WorkStealingPool* pool = nullptr;
+                std::size_t index = 0;
+            };
+
+            static WorkerContext& CurrentWorker() {
+                static thread_local WorkerContext context;
+                return context;
+            }
+
+            void Submit(PoolTask&& task) {
+                WorkerContext& current = CurrentWorker();
+                std::size_t index = current.pool == this
+                    ? current.index
+                    : _next_queue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+                {
+                    std::lock_guard<std::mutex> lock(_queues[index]->mutex);
+                    _queues[index]->tasks.push_back(std::move(task));
+                }
+
+                _pending.fetch_add(1, std::memory_order_seq_cst);
+                if (_sleepers.load(std::memory_order_seq_cst) > 0) {
+                    std::lock_guard<std::mutex> lock(_sleep_mutex);
+                    _wake.notify_one();
+                }
+            }
+
+            bool PopLocal(std::size_t index, PoolTask& task) {
+                WorkerQueue& queue = *_queues[index];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (queue.tasks.empty()) {
+                    return false;
+                }
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                return true;
+            }
+
+            bool Steal(std::size_t thief, std::minstd_rand& random, PoolTask& task) {
+                std::size_t count = _queues.size();
+                std::size_t start = random() % count;
+                for (std::size_t i = 0; i < count; ++i) {
+                    std::size_t victim = (start + i) % count;
+                    if (victim == thief) {
+                        continue;
+                    }
+                    WorkerQueue& queue = *_queues[victim];
+                    std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+                    if (lock.owns_lock() && !queue.tasks.empty()) {
+                        task = std::move(queue.tasks.front());
+                        queue.tasks.pop_front();
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void Run(std::size_t index) {
+                CurrentWorker() = { this, index };
+                std::minstd_rand random(static_cast<unsigned>(index + 1));
+
+                for (;;) {
+                    PoolTask task;
+                    if (PopLocal(index, task) || Steal(index, random, task)) {
+                        _pending.fetch_sub(1, std::memory_order_relaxed);
+                        task();
+                        continue;
+                    }
+
+                    std::unique_lock<std::mutex> lock(_sleep_mutex);
+                    _sleepers.fetch_add(1, std::memory_order_seq_cst);
+                    // Pairs with Submit: either the submitter sees us as a
+                    // sleeper and notifies, or we see its pending task here.
+                    _wake.wait(lock, [this]() {
+                        return _stopped || _pending.load(std::memory_order_seq_cst) > 0;
+                    });
+                    _sleepers.fetch_sub(1, std::memory_order_relaxed);
+                    if (_stopped) {
+                        return;
+                    }
+                }
+            }
+
+            std::vector<std::unique_ptr<WorkerQueue>> _queues;
+            std::vector<std::thread> _threads;
+
+            alignas(kCacheLineSize) std::atomic<std::size_t> _next_queue{ 0 };
+            alignas(kCacheLineSize) std::atomic<std::ptrdiff_t> _pending{ 0 };
+            std::atomic<std::size_t> _sleepers{ 0 };
+            std::mutex _sleep_mutex;
+            std::condition_variable _wake;
+            bool _stopped = false;
+        };
+    }
+}
+
+#endif  // OUTMAN_DETAIL_WORK_STEALING_POOL_HPP
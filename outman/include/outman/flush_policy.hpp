@@ -0,0 +1,50 @@
+#ifndef OUTMAN_FLUSH_POLICY_HPP
+#define OUTMAN_FLUSH_POLICY_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace outman {
+    // When a flushable strategy registered with a policy gets FlushAsync.
+    // The manager calls AddAsync per record and FlushAsync once any enabled
+    // threshold is reached; a threshold of 0 is disabled. With none enabled
+    // it flushes after every drained batch.
+    struct FlushPolicy {
+        // Bytes added since the last flush, as measured by RecordSize.
+        std::size_t max_bytes = 0;
+        std::size_t max_records = 0;
+        // Age of the oldest record added since the last flush, counted from
+        // when it was saved. Age flushes come at most once per max_age, so
+        // a backlog of records that are already old is not flushed record
+        // by record.
+        std::chrono::milliseconds max_age{ 0 };
+
+        // Adaptive mode when non-zero: the manager measures how long records
+        // wait for their flush and steers the thresholds so the 99th
+        // percentile stays under this target. Batches grow while there is
+        // headroom and shrink when the target is missed; max_records and
+        // max_bytes become upper bounds and max_age is ignored.
+        std::chrono::milliseconds staleness_target{ 0 };
+    };
+
+    // Bytes a record adds to a flushable strategy's buffer. Containers
+    // count their elements, everything else its sizeof; specialize it for
+    // records with a better estimate.
+    template <typename TData, typename = void>
+    struct RecordSize {
+        std::size_t operator()(const TData&) const {
+            return sizeof(TData);
+        }
+    };
+
+    template <typename TData>
+    struct RecordSize<TData, std::void_t<typename TData::value_type, decltype(std::declval<const TData&>().size())>> {
+        std::size_t operator()(const TData& data) const {
+            return data.size() * sizeof(typename TData::value_type);
+        }
+    };
+}
+
+#endif  // OUTMAN_FLUSH_POLICY_HPP
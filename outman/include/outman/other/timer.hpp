@@ -0,0 +1,221 @@
+#ifndef OUTMAN_OTHER_TIMER_HPP
+#define OUTMAN_OTHER_TIMER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace outman {
+    namespace detail {
+        // One periodic callback on a TimerWheel.
+        struct TimerEntry {
+            std::function<void()> callback;
+            std::size_t interval_ticks = 1;
+            // Full wheel turns left before the entry is due; wheel thread only.
+            std::size_t rounds = 0;
+            std::atomic<bool> cancelled{ false };
+            // Set while a fired callback runs, so a slow callback is skipped
+            // rather than run twice at once.
+            std::atomic<bool> running{ false };
+        };
+
+        // Hashed timing wheel of periodic callbacks. Scheduling and expiring
+        // an entry is O(1) however many entries there are, and a tick only
+        // visits the one slot it lands on.
+        //
+        // Only one thread at a time may call Advance (the manager runs it on
+        // its timer strand). Add and cancelling may be done from any thread:
+        // new entries go through a lock-free inbox that Advance drains, and
+        // cancelled entries are dropped lazily when their slot comes up.
+        class TimerWheel {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+            TimerWheel(std::chrono::milliseconds resolution, std::size_t slot_count = 512)
+                : _resolution(std::max(resolution, std::chrono::milliseconds(1))),
+                _slots(RoundUpToPowerOfTwo(std::max<std::size_t>(slot_count, 2))),
+                _mask(_slots.size() - 1),
+                _epoch(Clock::now()) {}
+
+            ~TimerWheel() {
+                InboxNode* node = _inbox.exchange(nullptr, std::memory_order_acquire);
+                while (node) {
+                    InboxNode* next = node->next;
+                    delete node;
+                    node = next;
+                }
+            }
+
+            TimerWheel(const TimerWheel&) = delete;
+            TimerWheel& operator=(const TimerWheel&) = delete;
+
+            // Any thread. The first call comes one interval from the next Advance.
+            std::shared_ptr<TimerEntry> Add(std::function<void()> callback, std::chrono::milliseconds interval) {
+                auto entry = std::make_shared<TimerEntry>();
+                entry->callback = std::move(callback);
+                entry->interval_ticks = std::max<std::size_t>(
+                    static_cast<std::size_t>((interval + _resolution - std::chrono::milliseconds(1)) / _resolution), 1);
+
+                auto* node = new InboxNode{ entry, _inbox.load(std::memory_order_relaxed) };
+                while (!_inbox.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+                }
+                return entry;
+            }
+
+            // Wheel thread. Runs `fire` for every entry due up to `now`.
+            template <typename TFire>
+            void Advance(Clock::time_point now, TFire&& fire) {
+                auto target = static_cast<std::size_t>((now - _epoch) / _resolution);
+                if (_entry_count == 0) {
+                    // Nothing to visit on the way; skip idle time in one step.
+                    _cursor = std::max(_cursor, target);
+                }
+                while (_cursor < target) {
+                    ++_cursor;
+                    TickSlot(_slots[_cursor & _mask], fire);
+                }
+                // New entries count their interval from the current tick.
+                DrainInbox();
+            }
+
+            // Wheel thread. Runs `fire` for every live entry.
+            template <typename TFire>
+            void ForEach(TFire&& fire) {
+                DrainInbox();
+                for (const auto& slot : _slots) {
+                    for (const auto& entry : slot) {
+                        if (!entry->cancelled.load(std::memory_order_relaxed)) {
+                            fire(entry);
+                        }
+                    }
+                }
+            }
+
+            // Wheel thread. Time of the earliest tick with something to do, or
+            // Clock::time_point::max() if nothing is scheduled. New entries in
+            // the inbox need the next tick to be scheduled; a cancelled entry
+            // is due at its slot, which drops it.
+            Clock::time_point NextTick() const {
+                if (_inbox.load(std::memory_order_acquire)) {
+                    return TickTime(_cursor + 1);
+                }
+                if (_entry_count == 0) {
+                    return Clock::time_point::max();
+                }
+                // Visiting slots in tick order, the first entry due this turn
+                // beats any entry in a later slot or turn.
+                std::size_t earliest = std::numeric_limits<std::size_t>::max();
+                for (std::size_t ticks = 1; ticks <= _slots.size() && ticks < earliest; ++ticks) {
+                    for (const auto& entry : _slots[(_cursor + ticks) & _mask]) {
+                        std::size_t rounds = entry->cancelled.load(std::memory_order_relaxed) ? 0 : entry->rounds;
+                        earliest = std::min(earliest, ticks + rounds * _slots.size());
+                    }
+                }
+                return TickTime(_cursor + earliest);
+            }
+
+        private:
+            struct InboxNode {
+                std::shared_ptr<TimerEntry> entry;
+                InboxNode* next;
+            };
+
+            using Slot = std::vector<std::shared_ptr<TimerEntry>>;
+
+            Clock::time_point TickTime(std::size_t tick) const {
+                return _epoch + _resolution * static_cast<Clock::rep>(tick);
+            }
+
+            static std::size_t RoundUpToPowerOfTwo(std::size_t value) {
+                std::size_t result = 1;
+                while (result < value) {
+                    result <<= 1;
+                }
+                return result;
+            }
+
+            void DrainInbox() {
+                InboxNode* node = _inbox.exchange(nullptr, std::memory_order_acquire);
+                while (node) {
+                    Schedule(std::move(node->entry));
+                    InboxNode* next = node->next;
+                    delete node;
+                    node = next;
+                }
+            }
+
+            void Schedule(std::shared_ptr<TimerEntry> entry) {
+                std::size_t ticks = entry->interval_ticks;
+                entry->rounds = (ticks - 1) / _slots.size();
+                _slots[(_cursor + ticks) & _mask].push_back(std::move(entry));
+                ++_entry_count;
+            }
+
+            template <typename TFire>
+            void TickSlot(Slot& slot, TFire& fire) {
+                Slot due;
+                for (std::size_t i = 0; i < slot.size();) {
+                    auto& entry = slot[i];
+                    if (entry->cancelled.load(std::memory_order_relaxed)) {
+                        Remove(slot, i);
+                    }
+                    else if (entry->rounds > 0) {
+                        --entry->rounds;
+                        ++i;
+                    }
+                    else {
+                        due.push_back(std::move(entry));
+                        Remove(slot, i);
+                    }
+                }
+                // Re-scheduled after the scan: an interval of a whole number
+                // of turns lands in this very slot.
+                for (auto& entry : due) {
+                    fire(entry);
+                    Schedule(std::move(entry));
+                }
+            }
+
+            void Remove(Slot& slot, std::size_t index) {
+                slot[index] = std::move(slot.back());
+                slot.pop_back();
+                --_entry_count;
+            }
+
+            const std::chrono::milliseconds _resolution;
+            std::vector<Slot> _slots;
+            const std::size_t _mask;
+            const Clock::time_point _epoch;
+            std::size_t _cursor = 0;
+            std::size_t _entry_count = 0;
+            std::atomic<InboxNode*> _inbox{ nullptr };
+        };
+    }
+
+    // Handle of a periodic flush registered with an OutputManager. Dropping
+    // the handle leaves the flush registered; Cancel removes it.
+    class FlushRegistration {
+    public:
+        FlushRegistration() = default;
+
+        explicit FlushRegistration(std::weak_ptr<detail::TimerEntry> entry) : _entry(std::move(entry)) {}
+
+        // Any thread. A flush that already started still completes.
+        void Cancel() {
+            if (auto entry = _entry.lock()) {
+                entry->cancelled.store(true, std::memory_order_relaxed);
+            }
+            _entry.reset();
+        }
+
+    private:
+        std::weak_ptr<detail::TimerEntry> _entry;
+    };
+}
+
+#endif  // OUTMAN_OTHER_TIMER_HPP
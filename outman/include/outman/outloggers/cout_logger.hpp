@@ -13,7 +13,7 @@ public:
     CoutLogger() = default;
     virtual ~CoutLogger() = default;
 
-    void Log(const std::string& message, const void* sender) override {
+    void Log(const std::string& message, outman::SenderId sender) override {
         static constexpr std::hash<std::thread::id> hash{};
         std::ostringstream ss_hash;
         auto thread_id_hash = hash(std::this_thread::get_id());
@@ -24,19 +24,10 @@ public:
 
         std::string hash_str = ss_hash.str();
 
-        std::string sender_info = "sender_unknown_";
+        const std::string& sender_name = sender.Name();
+        std::string sender_info = sender_name.empty() ? "sender_unknown" : sender_name;
 
-        if (sender == static_cast<const void*>(&outman::OutputManager::Instance())) {
-            sender_info = "outman_";
-        }
-        else {
-            const std::string* sender_string = static_cast<const std::string*>(sender);
-            if (sender_string) {
-                sender_info = *sender_string;
-            }
-        }
-
-        sender_info += hash_str;
+        sender_info += "_" + hash_str;
 
         std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
         auto epoch_time = now.time_since_epoch();
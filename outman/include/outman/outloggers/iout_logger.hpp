@@ -2,8 +2,10 @@
 
 #include <string>
 
+#include "../sender_id.hpp"
+
 class IOutLogger {
 public:
     virtual ~IOutLogger() = default;
-    virtual void Log(const std::string& message, const void* sender) = 0;
+    virtual void Log(const std::string& message, outman::SenderId sender) = 0;
 };
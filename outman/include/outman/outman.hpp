@@ -4,6 +4,7 @@
 #define BOOST_ASIO_STANDALONE
 
 #include "output_manager.hpp"
+#include "output_channel.hpp"
 
 namespace outman {
     namespace om {
@@ -12,7 +13,7 @@ namespace outman {
             OutputManager::Instance().Save(data);
         }
 
-		inline void Log(const std::string& message, const void* sender) {
+		inline void Log(const std::string& message, SenderId sender) {
             OutputManager::Instance().Log(message, sender);
         }
     }
@@ -0,0 +1,111 @@
+#ifndef OUTMAN_OUTPUT_CHANNEL_HPP
+#define OUTMAN_OUTPUT_CHANNEL_HPP
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <shared_mutex>
+#include <type_traits>
+
+#include "output_manager.hpp"
+
+namespace outman {
+    // Pre-resolved handle for one record type, obtained with
+    // OutputManager::Channel<TData>(). Save calls skip the type_index lookup
+    // and the registry lock: the handle caches the strategy list and the
+    // ingestion ring and only re-reads them when the registry version changes.
+    //
+    // A handle is cheap to copy but is not meant to be shared between
+    // threads; give every producer thread its own copy.
+    template <typename TData>
+    class OutputChannel {
+    public:
+        void Save(const TData& data, SenderId sender) {
+            for (const auto& slot : *View().strategies) {
+                slot->Strategy()->Save(data, sender);
+            }
+        }
+
+        void SaveAsync(const TData& data, SenderId sender) {
+            SaveAsync(MakePayload(data), sender);
+        }
+
+        void SaveAsync(TData&& data, SenderId sender) {
+            SaveAsync(MakePayload(std::move(data)), sender);
+        }
+
+        void SaveAsync(std::unique_ptr<TData> data, SenderId sender) {
+            if (data) {
+                SaveAsync(MakePayload(std::move(data)), sender);
+            }
+        }
+
+        void SaveAsync(SharedPayload<TData> payload, SenderId sender) {
+            if (payload) {
+                _manager->Submit(View(), payload, sender, true);
+            }
+        }
+
+        // See OutputManager::SaveAsync with a completion token.
+        template <typename CompletionToken>
+        auto SaveAsync(const TData& data, SenderId sender, CompletionToken&& token) {
+            return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr)>(
+                [this, sender](auto handler, SharedPayload<TData> payload) {
+                    using Handler = decltype(handler);
+                    _manager->Submit(View(), payload, sender, true,
+                        std::make_shared<detail::HandlerCompletion<Handler>>(std::move(handler), _manager->_executor));
+                },
+                token, MakePayload(data));
+        }
+
+        std::uint64_t SaveAsyncTracked(const TData& data, SenderId sender) {
+            std::uint64_t sequence = _manager->_completion_tracker.Begin();
+            _manager->Submit(View(), MakePayload(data), sender, true,
+                std::make_shared<detail::TrackedCompletion>(_manager->_completion_tracker, sequence));
+            return sequence;
+        }
+
+        SaveAsyncResult TrySaveAsync(const TData& data, SenderId sender) {
+            return TrySaveAsync(MakePayload(data), sender);
+        }
+
+        SaveAsyncResult TrySaveAsync(SharedPayload<TData> payload, SenderId sender) {
+            if (!payload) {
+                return SaveAsyncResult();
+            }
+            return _manager->Submit(View(), payload, sender, false);
+        }
+
+        std::size_t StrategyCount() {
+            return View().strategies->size();
+        }
+
+    private:
+        friend class OutputManager;
+
+        OutputChannel(OutputManager& manager, std::shared_ptr<detail::ChannelState<TData>> state)
+            : _manager(&manager) {
+            _view.state = std::move(state);
+            Refresh();
+        }
+
+        const detail::ChannelView<TData>& View() {
+            if (_view.state->Version() != _version) {
+                Refresh();
+            }
+            return _view;
+        }
+
+        void Refresh() {
+            std::shared_lock lock(_manager->_strategies_mutex);
+            _version = _view.state->Version();
+            _view = _view.state->View(_view.state);
+        }
+
+        OutputManager* _manager;
+        detail::ChannelView<TData> _view;
+        std::uint64_t _version = 0;
+    };
+}
+
+#endif  // OUTMAN_OUTPUT_CHANNEL_HPP
@@ -6,245 +6,1190 @@
 #endif // !BOOST_ALL_NO_LIB 
 
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 #include <typeindex>
 #include <typeinfo>
 #include <shared_mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <boost/asio.hpp>
-#include <boost/asio/thread_pool.hpp>
 
+#include "backpressure.hpp"
+#include "channel_options.hpp"
+#include "data/shared_payload.hpp"
+#include "flush_policy.hpp"
+#include "detail/channel_state.hpp"
+#include "detail/handler_gate.hpp"
+#include "detail/priority_scheduler.hpp"
+#include "detail/save_completion.hpp"
+#include "detail/thread_setup.hpp"
+#include "detail/work_stealing_pool.hpp"
+#include "other/timer.hpp"
+#include "output_manager_config.hpp"
+#include "priority.hpp"
+#include "sender_id.hpp"
+#include "shutdown.hpp"
+#include "sync_policy.hpp"
 #include "outloggers/iout_logger.hpp"
+#include "strategies/executor_bound_strategy.hpp"
+#include "strategies/group_commit_strategy.hpp"
 #include "strategies/isaving_strategy.hpp"
 
 namespace outman {
+    template <typename TData>
+    class OutputChannel;
+
+    // Managers are independent: each one has its own strategy registry,
+    // workers and flush timer, so outputs registered with one never queue
+    // behind another's. Instance() is a process-wide default for code that
+    // does not need that isolation.
     class OutputManager {
     public:
+        explicit OutputManager(OutputManagerConfig config = OutputManagerConfig());
+        ~OutputManager();
+
+        OutputManager(const OutputManager&) = delete;
+        OutputManager& operator=(const OutputManager&) = delete;
+        OutputManager(OutputManager&&) = delete;
+        OutputManager& operator=(OutputManager&&) = delete;
+
         static OutputManager& Instance();
 
+        // Sets the configuration Instance() is created with. Must be called
+        // before the first Instance() call; throws std::logic_error otherwise.
+        static void Configure(OutputManagerConfig config);
+
+        // Executor all output work runs on (internal workers or the one
+        // supplied through OutputManagerConfig::executor).
+        boost::asio::any_io_executor GetExecutor() const;
+
+        // Registers a strategy for TData. `limits` bounds the records queued
+        // for it and selects what happens to new records once it is full;
+        // `priority` sets its share of the workers when outputs compete.
+        template <typename TData>
+        void AddStrategy(
+            std::shared_ptr<ISavingStrategy<TData>> strategy,
+            const QueueLimits& limits = QueueLimits(),
+            OutputPriority priority = OutputPriority::Normal
+        );
+
+        // Registers a flushable strategy for TData that gets AddAsync per
+        // record and FlushAsync when `policy` says so (size, count, age, or
+        // an adaptive staleness target; see flush_policy.hpp).
+        template <typename TData>
+        void AddFlushableStrategy(
+            std::shared_ptr<IFlushableSavingStrategy<TData>> strategy,
+            const FlushPolicy& policy,
+            const QueueLimits& limits = QueueLimits(),
+            OutputPriority priority = OutputPriority::Normal
+        );
+
+        // Returns a handle bound to the strategies of TData (see output_channel.hpp).
+        template <typename TData>
+        OutputChannel<TData> Channel();
+
+        template <typename TData>
+        void Save(const TData& data, SenderId sender);
+
+        template <typename TData>
+        void SaveAsync(const TData& data, SenderId sender);
+
+        // Moves the record into a single shared payload instead of copying it.
+        template <typename TData, typename = std::enable_if_t<!std::is_lvalue_reference_v<TData>>>
+        void SaveAsync(TData&& data, SenderId sender);
+
+        template <typename TData>
+        void SaveAsync(std::unique_ptr<TData> data, SenderId sender);
+
+        // Shares an already built payload; TData may be const-qualified.
+        template <typename TData>
+        void SaveAsync(std::shared_ptr<TData> data, SenderId sender);
+
+        // Completes `token` with void(std::exception_ptr) once every strategy
+        // registered for TData has taken the record: its save call returned
+        // or threw, or its queue dropped the record (RecordDroppedError). For
+        // sync and wrapped-sync strategies that call is Save itself, so the
+        // record has been written; group-committing sinks wait for their
+        // commit. The first error is passed on. Works with callbacks,
+        // boost::asio::use_future and, under C++20, boost::asio::use_awaitable.
+        template <typename TData, typename CompletionToken>
+        auto SaveAsync(const TData& data, SenderId sender, CompletionToken&& token);
+
+        // SaveAsync returning a sequence number for WaitUntilDurable. Errors
+        // are only logged.
+        template <typename TData>
+        std::uint64_t SaveAsyncTracked(const TData& data, SenderId sender);
+
+        // Highest sequence at or below which every tracked save has completed.
+        std::uint64_t DurableWatermark() const;
+
+        // Waits until the tracked save `sequence` and every one before it
+        // have completed; returns false on timeout.
+        bool WaitUntilDurable(std::uint64_t sequence, std::chrono::steady_clock::duration timeout);
+
+        // Like SaveAsync, but never blocks: strategies whose queue is full
+        // under the Block or FailFast policy reject the record, and the
+        // result tells how many strategies accepted it.
         template <typename TData>
-        void AddStrategy(std::shared_ptr<ISavingStrategy<TData>> strategy);
+        SaveAsyncResult TrySaveAsync(const TData& data, SenderId sender);
 
+        template <typename TData, typename = std::enable_if_t<!std::is_lvalue_reference_v<TData>>>
+        SaveAsyncResult TrySaveAsync(TData&& data, SenderId sender);
+
+        template <typename TData>
+        SaveAsyncResult TrySaveAsync(std::shared_ptr<TData> data, SenderId sender);
+
+        // Queue counters of every strategy registered for TData, in
+        // registration order.
         template <typename TData>
-        void Save(const TData& data, const void* sender);
+        std::vector<BackpressureStats> GetBackpressureStats();
 
+        // Selects how records of TData are ingested. Call it before producing
+        // records of that type.
         template <typename TData>
-        void SaveAsync(const TData& data, const void* sender);
+        void ConfigureChannel(const ChannelOptions& options);
+
+        // Counters of the ingestion ring of TData (all zero in Queue mode).
+        template <typename TData>
+        BackpressureStats GetIngestionStats();
+
+        // Stops accepting records (later saves are rejected with
+        // OutputStoppedError), hands off producer batches, waits until every
+        // queued record reached its strategies or the deadline passed, then
+        // stops the flush timer, flushes the flushable strategies and commits
+        // the group-committing ones (each in its own lane, after its records)
+        // and runs every registered flush once more. Workers keep running
+        // until the manager is destroyed, so it may be called more than once.
+        ShutdownReport Shutdown(std::chrono::steady_clock::time_point deadline);
 
+        // Calls FlushAsync on the strategy every `interval` (rounded up to
+        // OutputManagerConfig::flush_tick). A strategy registered with this
+        // manager is flushed by its own drain, between two batches of its
+        // records and never alongside its other calls; any other one is
+        // flushed on the workers at High priority. A flush is skipped while
+        // the previous one still runs.
         template <typename TData>
-        void RegisterFlushableStrategy(const std::shared_ptr<IFlushableSavingStrategy<TData>>& strategy, std::chrono::milliseconds interval);
+        FlushRegistration RegisterFlushableStrategy(const std::shared_ptr<IFlushableSavingStrategy<TData>>& strategy, std::chrono::milliseconds interval);
+
+        // Same for any flush callback.
+        FlushRegistration RegisterFlush(std::function<void()> flush, std::chrono::milliseconds interval);
 
         void FlushTimerCallback();
         void SetLogger(const std::shared_ptr<IOutLogger>& logger);
-        void Log(const std::string& message, const void* sender);
+        void Log(const std::string& message, SenderId sender);
 
     private:
-        OutputManager();
-        ~OutputManager();
-
-        OutputManager(const OutputManager&) = delete;
-        OutputManager& operator=(const OutputManager&) = delete;
-        OutputManager(OutputManager&&) = delete;
-        OutputManager& operator=(OutputManager&&) = delete;
+        template <typename TData>
+        friend class OutputChannel;
 
-        static inline std::once_flag _instance_flag;
+        static OutputManagerConfig& PendingConfig();
+        static inline std::mutex _config_mutex;
+        static inline bool _instance_created = false;
 
         std::unordered_map<
             std::type_index,
-            std::vector<std::shared_ptr<ISavingStrategyBase>>
+            std::shared_ptr<detail::ChannelStateBase>
         > _strategies;
         std::shared_mutex _strategies_mutex;
 
-        std::unordered_map<
-            std::type_index,
-            std::vector<
-            std::tuple<
-            std::chrono::steady_clock::time_point,
-            std::chrono::milliseconds,
-            std::shared_ptr<ISavingStrategyBase>
-            >>> _flushable_strategies;
-        std::shared_mutex _flushable_strategies_mutex;
+        // Caller must hold _strategies_mutex exclusively.
+        template <typename TData>
+        std::shared_ptr<detail::ChannelState<TData>> GetOrCreateChannelState();
 
+        template <typename TData>
+        std::shared_ptr<detail::StrategySlot<TData>> AddSlot(
+            std::shared_ptr<ISavingStrategy<TData>> strategy,
+            const QueueLimits& limits,
+            OutputPriority priority,
+            const std::optional<FlushPolicy>& flush_policy
+        );
+
+        // Producer batchers swept by the flush timer.
+        std::vector<std::weak_ptr<detail::ProducerBatcherBase>> _batchers;
+        std::mutex _batchers_mutex;
+
+        OutputManagerConfig _config;
         boost::asio::io_context _io_context;
         boost::asio::executor_work_guard<boost::asio::io_context::executor_type> _work_guard;
-        std::thread _io_thread;
-        boost::asio::thread_pool _thread_pool;
+        // Set when the internal workers use SchedulerKind::WorkStealing.
+        std::unique_ptr<detail::WorkStealingPool> _work_stealing_pool;
+        boost::asio::any_io_executor _executor;
+        // Every handler posted with `this` goes through the gate, which the
+        // destructor closes: the executor may belong to the application and
+        // outlive the manager.
+        detail::HandlerGate _handlers;
+        std::vector<std::thread> _workers;
         boost::asio::steady_timer _timer;
+        // Serializes FlushTimerCallback runs, including re-arms after new
+        // registrations.
+        boost::asio::strand<boost::asio::any_io_executor> _timer_strand;
+        // Runs strategy drain tasks by priority class.
+        detail::PriorityScheduler _drain_scheduler;
+        // Periodic flushes; only touched on _timer_strand apart from Add.
+        detail::TimerWheel _flush_wheel;
+        // Set on _timer_strand by StopFlushTimer.
+        bool _flush_timer_stopped = false;
+        detail::CompletionTracker _completion_tracker;
+
+        std::atomic<bool> _accepting{ true };
+        std::atomic<std::uint64_t> _rejected_after_shutdown{ 0 };
+        std::atomic<bool> _shutdown_called{ false };
 
+        void FlushBatchers();
+
+        void RearmFlushTimer();
+
+        // Runs a due flush on the workers.
+        void FireFlush(const std::shared_ptr<detail::TimerEntry>& entry);
+
+        // Runs every registered flush on the timer strand; waits until done
+        // or `deadline`.
+        void FlushAllRegistered(std::chrono::steady_clock::time_point deadline);
+
+        // Stops periodic flushes for good; waits until done or `deadline`.
+        void StopFlushTimer(std::chrono::steady_clock::time_point deadline);
+
+        // Waits until every channel is idle; returns false at `deadline`.
+        bool WaitUntilIdle(std::chrono::steady_clock::time_point deadline);
+
+        // Names, pins and prioritizes internal worker `index`.
+        void SetUpWorkerThread(std::size_t index) const;
+
+        boost::asio::any_io_executor SelectExecutor();
+
+        // Returns an empty view if nothing was registered for TData.
         template <typename TData>
-        void ExecuteStrategyAsync(
-            const std::shared_ptr<ISavingStrategy<TData>>& strategy,
-            const TData& data,
-            const void* sender
+        detail::ChannelView<TData> FindChannel();
+
+        // `completion`, if set, is finished once every strategy took the record.
+        template <typename TData>
+        SaveAsyncResult SaveAsyncShared(
+            SharedPayload<TData> payload,
+            SenderId sender,
+            bool may_block,
+            std::shared_ptr<detail::SaveCompletion> completion = nullptr
         );
 
+        template <typename TData>
+        SaveAsyncResult Submit(
+            const detail::ChannelView<TData>& view,
+            const SharedPayload<TData>& payload,
+            SenderId sender,
+            bool may_block,
+            std::shared_ptr<detail::SaveCompletion> completion = nullptr
+        );
+
+        // Hands a batch of records to every strategy queue of the channel.
+        // With `may_block` it waits for room in full Block queues; otherwise
+        // the caller sized the batch to QueueRoom, and a queue another
+        // producer filled in the meantime takes the records beyond capacity.
+        template <typename TData>
+        void FanOut(
+            const std::shared_ptr<detail::ChannelState<TData>>& state,
+            const std::vector<detail::QueuedRecord<TData>>& batch,
+            bool may_block
+        );
+
+        // Records every strategy queue of the channel takes before one is full.
+        template <typename TData>
+        std::size_t QueueRoom(const std::shared_ptr<detail::ChannelState<TData>>& state);
+
+        // Fans a batch of ring records out to the strategy queues.
+        template <typename TData>
+        void DrainRing(
+            const std::shared_ptr<detail::ChannelState<TData>>& state,
+            const std::shared_ptr<detail::RingIngestion<TData>>& ring
+        );
+
+        // Queues the record for the slot; returns false if its limits rejected it.
+        template <typename TData>
+        bool ExecuteStrategyAsync(
+            const std::shared_ptr<detail::StrategySlot<TData>>& slot,
+            const SharedPayload<TData>& payload,
+            SenderId sender,
+            std::chrono::steady_clock::time_point submitted,
+            bool may_block,
+            const std::shared_ptr<detail::SaveCompletion>& completion
+        );
+
+        template <typename TData>
+        void ScheduleDrain(const std::shared_ptr<detail::StrategySlot<TData>>& slot);
+
+        // Has the slot's drain flush it after its current batch.
+        template <typename TData>
+        void RequestFlush(const std::shared_ptr<detail::StrategySlot<TData>>& slot);
+
+        // Hands one batch of queued records to the strategy, then yields so
+        // other outputs get their turn.
+        template <typename TData>
+        void DrainStrategy(const std::shared_ptr<detail::StrategySlot<TData>>& slot);
+
+        // Flushes a slot with a FlushPolicy once its controller says so.
+        template <typename TData>
+        static void FlushIfDue(
+            detail::StrategySlot<TData>& slot,
+            detail::FlushController& controller,
+            std::chrono::steady_clock::time_point now
+        );
+
+        static constexpr std::size_t _drain_batch_size = 64;
+
         std::shared_ptr<IOutLogger> logger_;
     };
 
-    OutputManager::OutputManager()
-        : _io_context(),
+    OutputManager::OutputManager(OutputManagerConfig config)
+        : _config(std::move(config)),
+        _io_context(),
         _work_guard(boost::asio::make_work_guard(_io_context)),
-        _timer(_io_context),
-        _thread_pool(3)
+        _executor(SelectExecutor()),
+        _timer(_executor),
+        _timer_strand(_executor),
+        _drain_scheduler(_executor, _config.priority_weights, _handlers),
+        _flush_wheel(_config.flush_tick)
     {
-        for (std::size_t i = 0; i < 3; ++i) {
-            boost::asio::post(_thread_pool, [&]() { _io_context.run(); });
+        if (!_config.executor && !_work_stealing_pool) {
+            std::size_t worker_count = std::max<std::size_t>(_config.worker_count, 1);
+            _workers.reserve(worker_count);
+            for (std::size_t i = 0; i < worker_count; ++i) {
+                _workers.emplace_back([this, i]() {
+                    SetUpWorkerThread(i);
+                    _io_context.run();
+                });
+            }
         }
-        FlushTimerCallback();
+        RearmFlushTimer();
     }
 
     // Destructor: clean up resources
     OutputManager::~OutputManager() {
+        if (!_shutdown_called.load()) {
+            auto report = Shutdown(std::chrono::steady_clock::now() + _config.shutdown_timeout);
+            if (!report.drained) {
+                std::cerr << "OutputManager: " << report.unwritten << " records not written at shutdown" << std::endl;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(_batchers_mutex);
+            for (const auto& weak_batcher : _batchers) {
+                if (auto batcher = weak_batcher.lock()) {
+                    batcher->Close();
+                }
+            }
+        }
+        // From here on no handler of this manager runs, wherever it is queued.
+        _handlers.Close();
         _work_guard.reset();
         _io_context.stop();
-        if (_io_thread.joinable()) {
-            _io_thread.join();
+        for (auto& worker : _workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        if (_work_stealing_pool) {
+            _work_stealing_pool->Stop();
+        }
+        // Only once no handler can be re-arming it.
+        _timer.cancel();
+    }
+
+    boost::asio::any_io_executor OutputManager::SelectExecutor() {
+        if (_config.executor) {
+            return *_config.executor;
+        }
+        if (_config.scheduler == SchedulerKind::WorkStealing) {
+            _work_stealing_pool = std::make_unique<detail::WorkStealingPool>(
+                std::max<std::size_t>(_config.worker_count, 1),
+                [this](std::size_t index) {
+                    SetUpWorkerThread(index);
+                });
+            return _work_stealing_pool->get_executor();
+        }
+        return _io_context.get_executor();
+    }
+
+    void OutputManager::SetUpWorkerThread(std::size_t index) const {
+        const auto& affinity = _config.cpu_affinity;
+        detail::ApplyThreadSettings(
+            _config.thread_name_prefix + "-" + std::to_string(index),
+            affinity.empty() ? std::vector<int>() : affinity[index % affinity.size()],
+            _config.scheduling_policy,
+            _config.scheduling_priority);
+    }
+
+    OutputManagerConfig& OutputManager::PendingConfig() {
+        static OutputManagerConfig config;
+        return config;
+    }
+
+    void OutputManager::Configure(OutputManagerConfig config) {
+        std::lock_guard<std::mutex> lock(_config_mutex);
+        if (_instance_created) {
+            throw std::logic_error("OutputManager::Configure called after Instance()");
         }
+        PendingConfig() = std::move(config);
     }
 
-    // Corrected Instance() method
     OutputManager& OutputManager::Instance() {
-        static OutputManager instance;
-        std::call_once(_instance_flag, []() {
-            new (&instance) OutputManager();
-            });
+        static OutputManager instance([]() {
+            std::lock_guard<std::mutex> lock(_config_mutex);
+            _instance_created = true;
+            return PendingConfig();
+        }());
         return instance;
     }
 
+    boost::asio::any_io_executor OutputManager::GetExecutor() const {
+        return _executor;
+    }
+
     template <typename TData>
-    void OutputManager::AddStrategy(std::shared_ptr<ISavingStrategy<TData>> strategy) {
-        auto index = std::type_index(typeid(TData));
+    std::shared_ptr<detail::ChannelState<TData>> OutputManager::GetOrCreateChannelState() {
+        auto& state = _strategies[std::type_index(typeid(TData))];
+        if (!state) {
+            state = std::make_shared<detail::ChannelState<TData>>([this](const std::shared_ptr<detail::StrategySlot<TData>>& slot) {
+                ScheduleDrain(slot);
+            });
+        }
+        return std::static_pointer_cast<detail::ChannelState<TData>>(state);
+    }
+
+    template <typename TData>
+    void OutputManager::AddStrategy(
+        std::shared_ptr<ISavingStrategy<TData>> strategy,
+        const QueueLimits& limits,
+        OutputPriority priority
+    ) {
+        AddSlot(std::move(strategy), limits, priority, std::nullopt);
+    }
+
+    template <typename TData>
+    void OutputManager::AddFlushableStrategy(
+        std::shared_ptr<IFlushableSavingStrategy<TData>> strategy,
+        const FlushPolicy& policy,
+        const QueueLimits& limits,
+        OutputPriority priority
+    ) {
+        auto slot = AddSlot<TData>(std::move(strategy), limits, priority, policy);
+        auto interval = slot->GetFlushController()->CheckInterval();
+        if (interval.count() == 0) {
+            return;
+        }
+
+        // Age limits are checked by the flush timer; a due slot gets a drain
+        // without records, which flushes it in order with its AddAsync calls.
+        std::weak_ptr<detail::StrategySlot<TData>> weak_slot = slot;
+        RegisterFlush([this, weak_slot]() {
+            auto slot = weak_slot.lock();
+            if (slot && slot->GetFlushController()->Due(std::chrono::steady_clock::now())
+                && slot->Queue().RequestDrain()) {
+                ScheduleDrain(slot);
+            }
+        }, interval);
+    }
+
+    template <typename TData>
+    std::shared_ptr<detail::StrategySlot<TData>> OutputManager::AddSlot(
+        std::shared_ptr<ISavingStrategy<TData>> strategy,
+        const QueueLimits& limits,
+        OutputPriority priority,
+        const std::optional<FlushPolicy>& flush_policy
+    ) {
+        // Strategies that post work of their own do it on this manager's executor.
+        if (auto* executor_bound = dynamic_cast<IExecutorBoundStrategy*>(strategy.get())) {
+            executor_bound->BindExecutor(_executor);
+        }
+        std::shared_ptr<detail::StrategySlot<TData>> slot;
+        {
+            std::unique_lock lock(_strategies_mutex);
+            slot = GetOrCreateChannelState<TData>()->Add(std::move(strategy), limits, priority, flush_policy);
+        }
+
+        // Timed sync policies commit from the flush timer, records or not.
+        auto* committer = slot->Committer();
+        if (committer && committer->CommitCheckInterval().count() > 0) {
+            std::weak_ptr<detail::StrategySlot<TData>> weak_slot = slot;
+            RegisterFlush([weak_slot]() {
+                if (auto slot = weak_slot.lock()) {
+                    slot->Committer()->CommitIfDue(std::chrono::steady_clock::now());
+                }
+            }, committer->CommitCheckInterval());
+        }
+        return slot;
+    }
+
+    template <typename TData>
+    OutputChannel<TData> OutputManager::Channel() {
         std::unique_lock lock(_strategies_mutex);
-        _strategies[index].push_back(std::static_pointer_cast<ISavingStrategyBase>(strategy));
+        auto state = GetOrCreateChannelState<TData>();
+        lock.unlock();
+        return OutputChannel<TData>(*this, std::move(state));
     }
 
     template <typename TData>
-    void OutputManager::RegisterFlushableStrategy(
+    FlushRegistration OutputManager::RegisterFlushableStrategy(
         const std::shared_ptr<IFlushableSavingStrategy<TData>>& strategy,
         std::chrono::milliseconds interval
     ) {
-        auto key = std::type_index(typeid(TData));
-        std::unique_lock<std::shared_mutex> lock(_flushable_strategies_mutex);
-        auto& strategy_list = _flushable_strategies[key];
-        strategy_list.emplace_back(
-            std::make_tuple(std::chrono::steady_clock::now() + interval,
-                interval,
-                std::static_pointer_cast<ISavingStrategyBase>(strategy)
-            ));
+        return RegisterFlush([this, strategy]() {
+            bool registered = false;
+            if (auto view = FindChannel<TData>(); view.strategies) {
+                for (const auto& slot : *view.strategies) {
+                    if (slot->Strategy().get() == static_cast<ISavingStrategy<TData>*>(strategy.get())) {
+                        registered = true;
+                        RequestFlush(slot);
+                    }
+                }
+            }
+            if (!registered) {
+                strategy->FlushAsync(SenderId::Manager());
+            }
+        }, interval);
+    }
+
+    FlushRegistration OutputManager::RegisterFlush(std::function<void()> flush, std::chrono::milliseconds interval) {
+        auto entry = _flush_wheel.Add(std::move(flush), interval);
+        // Wakes the timer in case it sleeps past the new entry's first tick.
+        RearmFlushTimer();
+        return FlushRegistration(entry);
     }
 
     template <typename TData>
-    void OutputManager::Save(const TData& data, const void* sender) {
+    void OutputManager::Save(const TData& data, SenderId sender) {
         auto index = std::type_index(typeid(TData));
         std::shared_lock lock(_strategies_mutex);
         auto it = _strategies.find(index);
         if (it != _strategies.end()) {
-            for (const auto& strategy_ptr : it->second) {
-                auto strategy = std::static_pointer_cast<ISavingStrategy<TData>>(strategy_ptr);
-                strategy->Save(data, sender);
+            auto state = std::static_pointer_cast<detail::ChannelState<TData>>(it->second);
+            for (const auto& slot : *state->Strategies()) {
+                slot->Strategy()->Save(data, sender);
             }
         }
     }
 
     template <typename TData>
-    void OutputManager::SaveAsync(const TData& data, const void* sender) {
+    void OutputManager::SaveAsync(const TData& data, SenderId sender) {
+        SaveAsyncShared(MakePayload(data), sender, true);
+    }
+
+    template <typename TData, typename>
+    void OutputManager::SaveAsync(TData&& data, SenderId sender) {
+        SaveAsyncShared(MakePayload(std::move(data)), sender, true);
+    }
+
+    template <typename TData>
+    void OutputManager::SaveAsync(std::unique_ptr<TData> data, SenderId sender) {
+        if (data) {
+            SaveAsyncShared(MakePayload(std::move(data)), sender, true);
+        }
+    }
+
+    template <typename TData>
+    void OutputManager::SaveAsync(std::shared_ptr<TData> data, SenderId sender) {
+        if (data) {
+            SaveAsyncShared(SharedPayload<std::remove_const_t<TData>>(std::move(data)), sender, true);
+        }
+    }
+
+    template <typename TData, typename CompletionToken>
+    auto OutputManager::SaveAsync(const TData& data, SenderId sender, CompletionToken&& token) {
+        return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr)>(
+            [this, sender](auto handler, SharedPayload<TData> payload) {
+                using Handler = decltype(handler);
+                SaveAsyncShared(std::move(payload), sender, true,
+                    std::make_shared<detail::HandlerCompletion<Handler>>(std::move(handler), _executor));
+            },
+            token, MakePayload(data));
+    }
+
+    template <typename TData>
+    std::uint64_t OutputManager::SaveAsyncTracked(const TData& data, SenderId sender) {
+        std::uint64_t sequence = _completion_tracker.Begin();
+        SaveAsyncShared(MakePayload(data), sender, true,
+            std::make_shared<detail::TrackedCompletion>(_completion_tracker, sequence));
+        return sequence;
+    }
+
+    std::uint64_t OutputManager::DurableWatermark() const {
+        return _completion_tracker.Watermark();
+    }
+
+    bool OutputManager::WaitUntilDurable(std::uint64_t sequence, std::chrono::steady_clock::duration timeout) {
+        return _completion_tracker.WaitFor(sequence, timeout);
+    }
+
+    template <typename TData>
+    SaveAsyncResult OutputManager::TrySaveAsync(const TData& data, SenderId sender) {
+        return SaveAsyncShared(MakePayload(data), sender, false);
+    }
+
+    template <typename TData, typename>
+    SaveAsyncResult OutputManager::TrySaveAsync(TData&& data, SenderId sender) {
+        return SaveAsyncShared(MakePayload(std::move(data)), sender, false);
+    }
+
+    template <typename TData>
+    SaveAsyncResult OutputManager::TrySaveAsync(std::shared_ptr<TData> data, SenderId sender) {
+        if (!data) {
+            return SaveAsyncResult();
+        }
+        return SaveAsyncShared(SharedPayload<std::remove_const_t<TData>>(std::move(data)), sender, false);
+    }
+
+    template <typename TData>
+    std::vector<BackpressureStats> OutputManager::GetBackpressureStats() {
+        std::vector<BackpressureStats> stats;
+        if (auto view = FindChannel<TData>(); view.strategies) {
+            for (const auto& slot : *view.strategies) {
+                stats.push_back(slot->Queue().Stats());
+            }
+        }
+        return stats;
+    }
+
+    template <typename TData>
+    void OutputManager::ConfigureChannel(const ChannelOptions& options) {
+        std::unique_lock lock(_strategies_mutex);
+        auto state = GetOrCreateChannelState<TData>();
+
+        std::shared_ptr<detail::ProducerBatcher<TData>> batcher;
+        if (options.batch_size > 0) {
+            std::weak_ptr<detail::ChannelState<TData>> weak_state = state;
+            batcher = std::make_shared<detail::ProducerBatcher<TData>>(options,
+                [this, weak_state](const std::vector<detail::QueuedRecord<TData>>& batch, bool may_block) {
+                    auto state = weak_state.lock();
+                    if (!state) {
+                        return batch.size();
+                    }
+                    if (may_block) {
+                        FanOut(state, batch, true);
+                        return batch.size();
+                    }
+                    // The timer sweep hands off only what fits; the batcher
+                    // keeps the rest for its next sweep.
+                    std::size_t room = std::min(batch.size(), QueueRoom(state));
+                    if (room == batch.size()) {
+                        FanOut(state, batch, false);
+                    }
+                    else if (room > 0) {
+                        FanOut(state, std::vector<detail::QueuedRecord<TData>>(batch.begin(), batch.begin() + room), false);
+                    }
+                    return room;
+                });
+        }
+        auto replaced = state->Configure(options, batcher);
+        lock.unlock();
+
+        // Hand off what producers buffered in the replaced batcher; the
+        // registry lock must be released first as hand-offs read the registry.
+        if (replaced) {
+            replaced->FlushAll();
+            replaced->Close();
+        }
+        if (batcher) {
+            {
+                std::lock_guard<std::mutex> batchers_lock(_batchers_mutex);
+                _batchers.push_back(batcher);
+            }
+            RearmFlushTimer();
+        }
+    }
+
+    template <typename TData>
+    BackpressureStats OutputManager::GetIngestionStats() {
+        auto view = FindChannel<TData>();
+        return view.ring ? view.ring->Stats() : BackpressureStats();
+    }
+
+    template <typename TData>
+    detail::ChannelView<TData> OutputManager::FindChannel() {
         auto index = std::type_index(typeid(TData));
         std::shared_lock lock(_strategies_mutex);
         auto it = _strategies.find(index);
-        if (it != _strategies.end()) {
-            for (const auto& strategy_ptr : it->second) {
-                auto strategy = std::static_pointer_cast<ISavingStrategy<TData>>(strategy_ptr);
-                ExecuteStrategyAsync(strategy, data, sender);
+        if (it == _strategies.end()) {
+            return {};
+        }
+        auto state = std::static_pointer_cast<detail::ChannelState<TData>>(it->second);
+        return state->View(state);
+    }
+
+    template <typename TData>
+    SaveAsyncResult OutputManager::SaveAsyncShared(
+        SharedPayload<TData> payload,
+        SenderId sender,
+        bool may_block,
+        std::shared_ptr<detail::SaveCompletion> completion
+    ) {
+        // The view is read under the registry lock, but records are queued
+        // without it so a blocked producer never holds up AddStrategy.
+        auto view = FindChannel<TData>();
+        if (!view.state) {
+            if (completion) {
+                completion->Done();
             }
+            return SaveAsyncResult();
         }
+        return Submit(view, payload, sender, may_block, std::move(completion));
     }
 
+    // The submitter's hold on `completion` either travels with the record
+    // through the batcher or ring until FanOut, or is dropped here once the
+    // record is queued for every strategy.
     template <typename TData>
-    void OutputManager::ExecuteStrategyAsync(
-        const std::shared_ptr<ISavingStrategy<TData>>& strategy,
-        const TData& data,
-        const void* sender
+    SaveAsyncResult OutputManager::Submit(
+        const detail::ChannelView<TData>& view,
+        const SharedPayload<TData>& payload,
+        SenderId sender,
+        bool may_block,
+        std::shared_ptr<detail::SaveCompletion> completion
     ) {
-        auto save_handler = [strategy, data, sender](const boost::system::error_code& ec) {
-            if (ec) {
-                // Handle boost errors here
-                std::cerr << "Boost error: " << ec << " - " << ec.message() << std::endl;
+        SaveAsyncResult result;
+        if (!_accepting.load(std::memory_order_relaxed)) {
+            _rejected_after_shutdown.fetch_add(1, std::memory_order_relaxed);
+            if (completion) {
+                completion->Done(std::make_exception_ptr(OutputStoppedError()));
+            }
+            result.rejected = view.strategies->size();
+            return result;
+        }
+
+        auto submitted = std::chrono::steady_clock::now();
+        if (view.batcher && may_block) {
+            view.batcher->Append({ payload, sender, std::move(completion), submitted });
+            result.accepted = view.strategies->size();
+            return result;
+        }
+
+        if (view.ring) {
+            auto outcome = view.ring->Push({ payload, sender, completion, submitted }, may_block);
+            if (outcome.schedule_drain) {
+                boost::asio::post(_executor, _handlers.Wrap([this, state = view.state, ring = view.ring]() {
+                    DrainRing(state, ring);
+                }));
+            }
+            if (!outcome.accepted && completion) {
+                completion->Done(std::make_exception_ptr(RecordDroppedError(BackpressurePolicy::FailFast)));
+            }
+            (outcome.accepted ? result.accepted : result.rejected) = view.strategies->size();
+            return result;
+        }
+
+        if (completion) {
+            completion->AddPending(view.strategies->size());
+        }
+        for (const auto& slot : *view.strategies) {
+            if (ExecuteStrategyAsync(slot, payload, sender, submitted, may_block, completion)) {
+                ++result.accepted;
             }
             else {
-                try {
-                    if (auto wrapped_sync_strategy = std::dynamic_pointer_cast<IWrappedSyncSavingStrategy<TData>>(strategy)) {
-                        wrapped_sync_strategy->SaveAsync(data, sender);
-                    }
-                    else if (auto async_strategy = std::dynamic_pointer_cast<IAsyncSavingStrategy<TData>>(strategy)) {
-                        async_strategy->SaveAsync(data, sender);
-                    }
-                    else if (auto flushable_strategy = std::dynamic_pointer_cast<IFlushableSavingStrategy<TData>>(strategy)) {
-                        flushable_strategy->AddAsync(data, sender);
-                        flushable_strategy->FlushAsync(sender);
-                    }
-                    else {
-                        // Unsupported strategy type
-                    }
+                ++result.rejected;
+            }
+        }
+        if (completion) {
+            completion->Done();
+        }
+        return result;
+    }
+
+    template <typename TData>
+    void OutputManager::FanOut(
+        const std::shared_ptr<detail::ChannelState<TData>>& state,
+        const std::vector<detail::QueuedRecord<TData>>& batch,
+        bool may_block
+    ) {
+        std::shared_ptr<const detail::StrategyList<TData>> strategies;
+        {
+            std::shared_lock lock(_strategies_mutex);
+            strategies = state->Strategies();
+        }
+        for (const auto& record : batch) {
+            if (record.completion) {
+                record.completion->AddPending(strategies->size());
+            }
+        }
+        for (const auto& slot : *strategies) {
+            std::size_t next = 0;
+            if (slot->Queue().PushBatch(batch, next, !may_block).schedule_drain) {
+                ScheduleDrain(slot);
+            }
+            // The queue is full, so its drain is scheduled: wait for room with
+            // one record, then go on in bulk.
+            while (next < batch.size()) {
+                if (slot->Queue().Push(detail::QueuedRecord<TData>(batch[next++]), true).schedule_drain) {
+                    ScheduleDrain(slot);
+                }
+                if (slot->Queue().PushBatch(batch, next, false).schedule_drain) {
+                    ScheduleDrain(slot);
+                }
+            }
+        }
+        // Drop the holds the records carried from Submit.
+        for (const auto& record : batch) {
+            if (record.completion) {
+                record.completion->Done();
+            }
+        }
+    }
+
+    template <typename TData>
+    std::size_t OutputManager::QueueRoom(const std::shared_ptr<detail::ChannelState<TData>>& state) {
+        std::shared_ptr<const detail::StrategyList<TData>> strategies;
+        {
+            std::shared_lock lock(_strategies_mutex);
+            strategies = state->Strategies();
+        }
+        std::size_t room = std::numeric_limits<std::size_t>::max();
+        for (const auto& slot : *strategies) {
+            room = std::min(room, slot->Queue().Room());
+        }
+        return room;
+    }
+
+    template <typename TData>
+    void OutputManager::DrainRing(
+        const std::shared_ptr<detail::ChannelState<TData>>& state,
+        const std::shared_ptr<detail::RingIngestion<TData>>& ring
+    ) {
+        std::shared_ptr<const detail::StrategyList<TData>> strategies;
+        {
+            std::shared_lock lock(_strategies_mutex);
+            strategies = state->Strategies();
+        }
+        // A full Block queue keeps the records in the ring, where producers
+        // wait for room, instead of having them rejected; the drain stays
+        // scheduled and resumes once that queue's own drain made room.
+        std::size_t room = ring->DrainBatchSize();
+        for (const auto& slot : *strategies) {
+            room = std::min(room, slot->Queue().Room());
+            if (room == 0) {
+                slot->Queue().WhenRoom([this, state, ring]() {
+                    boost::asio::post(_executor, _handlers.Wrap([this, state, ring]() {
+                        DrainRing(state, ring);
+                    }));
+                });
+                return;
+            }
+        }
+
+        std::vector<detail::QueuedRecord<TData>> batch;
+        batch.reserve(room);
+        ring->PopBatch(batch, room);
+
+        if (!batch.empty()) {
+            FanOut(state, batch, false);
+        }
+
+        if (ring->ContinueDrain()) {
+            boost::asio::post(_executor, _handlers.Wrap([this, state, ring]() {
+                DrainRing(state, ring);
+            }));
+        }
+    }
+
+    template <typename TData>
+    bool OutputManager::ExecuteStrategyAsync(
+        const std::shared_ptr<detail::StrategySlot<TData>>& slot,
+        const SharedPayload<TData>& payload,
+        SenderId sender,
+        std::chrono::steady_clock::time_point submitted,
+        bool may_block,
+        const std::shared_ptr<detail::SaveCompletion>& completion
+    ) {
+        auto outcome = slot->Queue().Push({ payload, sender, completion, submitted }, may_block);
+        if (outcome.schedule_drain) {
+            ScheduleDrain(slot);
+        }
+        return outcome.accepted;
+    }
+
+    template <typename TData>
+    void OutputManager::ScheduleDrain(const std::shared_ptr<detail::StrategySlot<TData>>& slot) {
+        _drain_scheduler.Schedule(slot->Priority(), [this, slot]() {
+            DrainStrategy(slot);
+        });
+    }
+
+    template <typename TData>
+    void OutputManager::RequestFlush(const std::shared_ptr<detail::StrategySlot<TData>>& slot) {
+        if (slot->Queue().RequestFlush(false)) {
+            ScheduleDrain(slot);
+        }
+    }
+
+    template <typename TData>
+    void OutputManager::DrainStrategy(const std::shared_ptr<detail::StrategySlot<TData>>& slot) {
+        std::vector<detail::QueuedRecord<TData>> batch;
+        batch.reserve(_drain_batch_size);
+        slot->Queue().PopBatch(batch, _drain_batch_size);
+
+        // Records age from their submission, not from this drain.
+        auto* controller = slot->GetFlushController();
+        auto now = controller ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        auto* committer = slot->Committer();
+        std::vector<std::shared_ptr<detail::SaveCompletion>> uncommitted;
+
+        for (const auto& record : batch) {
+            std::exception_ptr error;
+            try {
+                slot->Dispatch(*record.payload, record.sender);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+
+            // Errors go to whoever waits on the record, or to std::cerr. A
+            // group-committing strategy holds the others until their commit.
+            if (record.completion && committer && !error) {
+                uncommitted.push_back(record.completion);
+            }
+            else if (record.completion) {
+                record.completion->Done(std::move(error));
+            }
+            else if (error) {
+                detail::ReportSaveError(error);
+            }
+            if (controller) {
+                controller->OnAdded(RecordSize<TData>()(*record.payload), record.submitted);
+                FlushIfDue(*slot, *controller, now);
+            }
+        }
+
+        if (controller) {
+            FlushIfDue(*slot, *controller, std::chrono::steady_clock::now());
+        }
+        // One waiter per batch; the strategy may commit right here.
+        if (committer && !batch.empty()) {
+            committer->WhenCommitted([uncommitted = std::move(uncommitted)](std::exception_ptr error) {
+                for (const auto& completion : uncommitted) {
+                    completion->Done(error);
                 }
-                catch (const std::exception& e) {
-                    // Handle other exceptions here
-                    std::cerr << "Error: " << e.what() << std::endl;
+            });
+        }
+
+        // A flush requested by a flush registration, or by Shutdown once the
+        // records queued before it are in.
+        if (slot->Queue().TakeFlushRequest()) {
+            if (slot->Kind() == detail::StrategyKind::Flushable) {
+                try {
+                    slot->Flush();
                 }
                 catch (...) {
-                    // Handle unknown exceptions here
-                    std::cerr << "Unknown error occurred" << std::endl;
+                    detail::ReportSaveError(std::current_exception());
                 }
+                if (controller) {
+                    controller->OnFlushed(std::chrono::steady_clock::now());
+                }
+            }
+            if (committer) {
+                committer->Commit();
             }
-        };
+        }
 
-        _io_context.post([save_handler]() {
-            save_handler(boost::system::error_code());
-		});
+        // Yield between batches so one busy sink cannot hog a worker, and so
+        // a higher priority drain can go first.
+        if (slot->Queue().FinishDrain()) {
+            ScheduleDrain(slot);
+        }
     }
 
 
-    void OutputManager::FlushTimerCallback() {
-        auto now = std::chrono::steady_clock::now();
-        std::chrono::milliseconds min_interval = std::chrono::milliseconds::max();
+    template <typename TData>
+    void OutputManager::FlushIfDue(
+        detail::StrategySlot<TData>& slot,
+        detail::FlushController& controller,
+        std::chrono::steady_clock::time_point now
+    ) {
+        if (!controller.ShouldFlush(now)) {
+            return;
+        }
+        try {
+            slot.Flush();
+        }
+        catch (...) {
+            detail::ReportSaveError(std::current_exception());
+        }
+        controller.OnFlushed(std::chrono::steady_clock::now());
+    }
+
+
+    ShutdownReport OutputManager::Shutdown(std::chrono::steady_clock::time_point deadline) {
+        auto start = std::chrono::steady_clock::now();
+        _shutdown_called.store(true);
+        _accepting.store(false);
+        FlushBatchers();
+
+        // The workers drain every queue in parallel; this thread only watches.
+        ShutdownReport report;
+        report.drained = WaitUntilIdle(deadline);
+
+        // The final flushes run as drains, so they stay in order with the
+        // records and never overlap a strategy's other calls; the timer goes
+        // first so no age flush races them.
+        StopFlushTimer(deadline);
+        {
+            std::shared_lock lock(_strategies_mutex);
+            for (const auto& item : _strategies) {
+                item.second->RequestFlush();
+            }
+        }
+        WaitUntilIdle(deadline);
         {
-            std::unique_lock<std::shared_mutex> lock(_flushable_strategies_mutex);
-            for (auto& item : _flushable_strategies) {
-                for (auto& strategy_tuple : item.second) {
-                    auto& next_flush_time = std::get<0>(strategy_tuple);
-                    auto& interval = std::get<1>(strategy_tuple);
-                    auto& strategy_ptr = std::get<2>(strategy_tuple);
-
-                    if (now >= next_flush_time) {
-                        auto strategy = std::dynamic_pointer_cast<
-                            IFlushableSavingStrategy<std::remove_reference_t<decltype(item.first)>>
-                        >(strategy_ptr);
-
-                        if (strategy != nullptr) {
-                            strategy->FlushAsync(nullptr);
-                        }
-                        next_flush_time = now + interval;
+            std::shared_lock lock(_strategies_mutex);
+            for (const auto& item : _strategies) {
+                report.unwritten += item.second->Pending();
+            }
+        }
+        FlushAllRegistered(deadline);
+        report.rejected = _rejected_after_shutdown.load();
+        report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        return report;
+    }
+
+    bool OutputManager::WaitUntilIdle(std::chrono::steady_clock::time_point deadline) {
+        for (;;) {
+            bool idle = true;
+            {
+                std::shared_lock lock(_strategies_mutex);
+                for (const auto& item : _strategies) {
+                    if (!item.second->Idle()) {
+                        idle = false;
+                        break;
                     }
+                }
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (idle || now >= deadline) {
+                return idle;
+            }
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                deadline - now, std::chrono::milliseconds(1)));
+        }
+    }
 
-                    min_interval = std::min(min_interval, std::chrono::duration_cast<std::chrono::milliseconds>(next_flush_time - now));
+    void OutputManager::FlushBatchers() {
+        std::vector<std::shared_ptr<detail::ProducerBatcherBase>> batchers;
+        {
+            std::lock_guard<std::mutex> lock(_batchers_mutex);
+            for (const auto& weak_batcher : _batchers) {
+                if (auto batcher = weak_batcher.lock()) {
+                    batchers.push_back(std::move(batcher));
                 }
             }
         }
+        // Outside the lock: hand-offs take the registry lock.
+        for (const auto& batcher : batchers) {
+            batcher->FlushAll();
+        }
+    }
 
-        // Schedule the next flush.
-        _timer.expires_after(min_interval);
-        _timer.async_wait([this](const boost::system::error_code error) {
+    void OutputManager::FlushTimerCallback() {
+        if (_flush_timer_stopped) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        _flush_wheel.Advance(now, [this](const std::shared_ptr<detail::TimerEntry>& entry) {
+            FireFlush(entry);
+        });
+        auto next_wake = _flush_wheel.NextTick();
+
+        {
+            // Sweep at half the batch age so no record waits much past it.
+            std::lock_guard<std::mutex> lock(_batchers_mutex);
+            for (auto it = _batchers.begin(); it != _batchers.end();) {
+                if (auto batcher = it->lock()) {
+                    batcher->Sweep(now);
+                    next_wake = std::min(next_wake, now + std::max(batcher->BatchAge() / 2, std::chrono::milliseconds(1)));
+                    ++it;
+                }
+                else {
+                    it = _batchers.erase(it);
+                }
+            }
+        }
+
+        // Nothing to wait for: the timer sleeps until a registration re-arms it.
+        if (next_wake == std::chrono::steady_clock::time_point::max()) {
+            return;
+        }
+        _timer.expires_at(next_wake);
+        _timer.async_wait(boost::asio::bind_executor(_timer_strand, _handlers.Wrap([this](const boost::system::error_code error) {
             if (!error) {
                 FlushTimerCallback();
             }
+            })));
+    }
+
+    void OutputManager::FireFlush(const std::shared_ptr<detail::TimerEntry>& entry) {
+        if (entry->running.exchange(true, std::memory_order_acquire)) {
+            return;
+        }
+        _drain_scheduler.Schedule(OutputPriority::High, [entry]() {
+            try {
+                entry->callback();
+            }
+            catch (...) {
+                detail::ReportSaveError(std::current_exception());
+            }
+            entry->running.store(false, std::memory_order_release);
+        });
+    }
+
+    void OutputManager::FlushAllRegistered(std::chrono::steady_clock::time_point deadline) {
+        auto done = std::make_shared<std::promise<void>>();
+        auto finished = done->get_future();
+        boost::asio::post(_timer_strand, _handlers.Wrap([this, done]() {
+            _flush_wheel.ForEach([](const std::shared_ptr<detail::TimerEntry>& entry) {
+                if (entry->running.exchange(true, std::memory_order_acquire)) {
+                    return;
+                }
+                try {
+                    entry->callback();
+                }
+                catch (...) {
+                    detail::ReportSaveError(std::current_exception());
+                }
+                entry->running.store(false, std::memory_order_release);
             });
+            done->set_value();
+        }));
+        finished.wait_until(deadline);
+    }
+
+    void OutputManager::StopFlushTimer(std::chrono::steady_clock::time_point deadline) {
+        auto done = std::make_shared<std::promise<void>>();
+        auto finished = done->get_future();
+        boost::asio::post(_timer_strand, _handlers.Wrap([this, done]() {
+            _flush_timer_stopped = true;
+            _timer.cancel();
+            done->set_value();
+        }));
+        finished.wait_until(deadline);
+    }
+
+    void OutputManager::RearmFlushTimer() {
+        boost::asio::post(_timer_strand, _handlers.Wrap([this]() {
+            FlushTimerCallback();
+        }));
     }
 
     void OutputManager::SetLogger(const std::shared_ptr<IOutLogger>& logger) {
         logger_ = logger;
     }
 
-    void OutputManager::Log(const std::string& message, const void* sender) {
+    void OutputManager::Log(const std::string& message, SenderId sender) {
         if (logger_) {
             logger_->Log(message, sender);
         } 
@@ -0,0 +1,68 @@
+#ifndef OUTMAN_OUTPUT_MANAGER_CONFIG_HPP
+#define OUTMAN_OUTPUT_MANAGER_CONFIG_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+#include <boost/asio/any_io_executor.hpp>
+
+#include "priority.hpp"
+
+namespace outman {
+    enum class SchedulingPolicy {
+        Default,    // Leave the OS defaults untouched
+        Other,      // SCHED_OTHER
+        Fifo,       // SCHED_FIFO, needs privileges
+        RoundRobin, // SCHED_RR, needs privileges
+        Batch,      // SCHED_BATCH
+        Idle        // SCHED_IDLE
+    };
+
+    enum class SchedulerKind {
+        // Internal workers share one io_context queue.
+        IoContext,
+        // Internal workers each own a task deque and steal from each other
+        // when idle (see detail/work_stealing_pool.hpp).
+        WorkStealing
+    };
+
+    struct OutputManagerConfig {
+        // Number of internal worker threads running the manager's io_context.
+        // Ignored when an executor is supplied; values below 1 are raised to 1.
+        std::size_t worker_count = 3;
+
+        // Workers are named "<prefix>-<index>" (truncated to the OS limit).
+        std::string thread_name_prefix = "outman";
+
+        // CPU sets to pin workers to; worker i uses cpu_affinity[i % size].
+        // Leave empty to let the OS place the workers.
+        std::vector<std::vector<int>> cpu_affinity;
+
+        SchedulingPolicy scheduling_policy = SchedulingPolicy::Default;
+        int scheduling_priority = 0;
+
+        // How the internal workers pick up strategy drains, ring drains and
+        // flush timer runs. Ignored when an executor is supplied.
+        SchedulerKind scheduler = SchedulerKind::IoContext;
+
+        // Worker share of each OutputPriority class (see priority.hpp).
+        PriorityWeights priority_weights = kDefaultPriorityWeights;
+
+        // Resolution of the flush timer wheel: flush intervals are rounded up
+        // to a multiple of it.
+        std::chrono::milliseconds flush_tick{ 5 };
+
+        // How long the destructor lets queued records drain when Shutdown
+        // was not called explicitly.
+        std::chrono::milliseconds shutdown_timeout{ 5000 };
+
+        // Run all output work on this executor (e.g. the application's own
+        // pool) instead of creating worker threads. Its execution context must
+        // outlive the manager.
+        std::optional<boost::asio::any_io_executor> executor;
+    };
+}
+
+#endif  // OUTMAN_OUTPUT_MANAGER_CONFIG_HPP
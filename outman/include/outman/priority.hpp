@@ -0,0 +1,29 @@
+#ifndef OUTMAN_PRIORITY_HPP
+#define OUTMAN_PRIORITY_HPP
+
+#include <array>
+#include <cstddef>
+
+namespace outman {
+    // Priority class of a strategy, chosen at AddStrategy time. Drain tasks
+    // of all strategies share the workers in proportion to the weight of
+    // their class, so urgent outputs overtake bulk ones without ever
+    // starving them.
+    enum class OutputPriority {
+        Low,
+        Normal,
+        High,
+        Critical
+    };
+
+    inline constexpr std::size_t kPriorityCount = 4;
+
+    // Share of worker time per priority class, indexed by OutputPriority.
+    // With every class busy, Low gets 1 drain batch for every 8 of Critical.
+    // Zero weights are raised to 1.
+    using PriorityWeights = std::array<std::size_t, kPriorityCount>;
+
+    inline constexpr PriorityWeights kDefaultPriorityWeights = { 1, 2, 4, 8 };
+}
+
+#endif  // OUTMAN_PRIORITY_HPP
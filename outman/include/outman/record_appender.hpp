@@ -0,0 +1,91 @@
+#ifndef OUTMAN_RECORD_APPENDER_HPP
+#define OUTMAN_RECORD_APPENDER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "record_serializers.hpp"
+
+namespace outman {
+    namespace detail {
+        // Integers that operator<< prints as numbers, not as characters.
+        template <typename T>
+        inline constexpr bool kIsNumericInteger = std::is_integral_v<T>
+            && !std::is_same_v<T, bool> && !std::is_same_v<T, char> && !std::is_same_v<T, signed char>
+            && !std::is_same_v<T, unsigned char> && !std::is_same_v<T, wchar_t>
+            && !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>;
+
+        // Appenders whose records all have the same size and can be
+        // written in place (see BinaryRecordAppender).
+        template <typename TAppender, typename = void>
+        inline constexpr bool kHasFixedSize = false;
+
+        template <typename TAppender>
+        inline constexpr bool kHasFixedSize<TAppender, std::void_t<decltype(TAppender::kFixedSize)>> = true;
+    }
+
+    // Appends one record, newline included, to a file sink's buffer.
+    // Text records are copied as they are, integers go through to_chars,
+    // records with OUTMAN_RECORD_FIELDS become CSV lines (see
+    // CsvRecordAppender) and everything else goes through its operator<<;
+    // specialize it for records with a cheaper or different line format.
+    template <typename TData, typename = void>
+    struct RecordAppender {
+        void operator()(std::string& buffer, const TData& record) const {
+            thread_local std::ostringstream stream;
+            stream.str(std::string());
+            stream.clear();
+            stream << record << '\n';
+            buffer += stream.str();
+        }
+    };
+
+    template <typename TData>
+    struct RecordAppender<TData, std::enable_if_t<std::is_convertible_v<const TData&, std::string_view>>> {
+        void operator()(std::string& buffer, const TData& record) const {
+            std::string_view text = record;
+            buffer.append(text.data(), text.size());
+            buffer.push_back('\n');
+        }
+    };
+
+    template <typename TData>
+    struct RecordAppender<TData, std::enable_if_t<detail::kIsNumericInteger<TData>>> {
+        void operator()(std::string& buffer, const TData& record) const {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), record);
+            buffer.append(digits, result.ptr);
+            buffer.push_back('\n');
+        }
+    };
+
+    template <typename TData>
+    struct RecordAppender<TData, std::enable_if_t<kHasRecordFields<TData>
+        && !std::is_convertible_v<const TData&, std::string_view> && !detail::kIsNumericInteger<TData>>>
+        : CsvRecordAppender<TData> {};
+
+    // Raw bytes of a trivially copyable record, with no separator. Sinks
+    // that can write in place use kFixedSize and Write instead of the
+    // buffer overload, so a record costs one memcpy.
+    template <typename TData>
+    struct BinaryRecordAppender {
+        static_assert(std::is_trivially_copyable_v<TData>, "binary records must be trivially copyable");
+
+        static constexpr std::size_t kFixedSize = sizeof(TData);
+
+        void Write(char* out, const TData& record) const {
+            std::memcpy(out, &record, sizeof(TData));
+        }
+
+        void operator()(std::string& buffer, const TData& record) const {
+            buffer.append(reinterpret_cast<const char*>(&record), sizeof(TData));
+        }
+    };
+}
+
+#endif  // OUTMAN_RECORD_APPENDER_HPP
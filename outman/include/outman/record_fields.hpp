@@ -0,0 +1,140 @@
+#ifndef OUTMAN_RECORD_FIELDS_HPP
+#define OUTMAN_RECORD_FIELDS_HPP
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace outman {
+    // One data member of a struct record: its name and member pointer.
+    template <typename TRecord, typename TValue>
+    struct RecordField {
+        using Record = TRecord;
+        using Value = TValue;
+
+        const char* name;
+        TValue TRecord::* member;
+
+        const TValue& Get(const TRecord& record) const {
+            return record.*member;
+        }
+    };
+
+    template <typename TRecord, typename TValue>
+    constexpr RecordField<TRecord, TValue> MakeRecordField(const char* name, TValue TRecord::* member) {
+        return { name, member };
+    }
+
+    // The data members of a struct record, in order, for sinks that write
+    // records field by field. Specialize it with OUTMAN_RECORD_FIELDS:
+    //
+    //     struct Tick { std::int64_t time; std::string symbol; double price; };
+    //     OUTMAN_RECORD_FIELDS(Tick, time, symbol, price)
+    //
+    // The macro opens namespace outman, so use it at global scope.
+    template <typename TData, typename = void>
+    struct RecordFields {};
+
+    template <typename TData, typename = void>
+    constexpr bool kHasRecordFields = false;
+
+    template <typename TData>
+    constexpr bool kHasRecordFields<TData, std::void_t<decltype(RecordFields<TData>::Get())>> = true;
+
+    template <typename TData>
+    constexpr std::size_t kRecordFieldCount = std::tuple_size_v<decltype(RecordFields<TData>::Get())>;
+
+    // Calls fn(field) for every field of TData, in declaration order.
+    template <typename TData, typename TFn>
+    void ForEachRecordField(TFn&& fn) {
+        std::apply([&fn](const auto&... fields) { (fn(fields), ...); }, RecordFields<TData>::Get());
+    }
+}
+
+#define OUTMAN_RECORD_FIELDS(Type, ...) \
+    namespace outman { \
+        template <> \
+        struct RecordFields<Type> { \
+            static constexpr auto Get() { \
+                return std::make_tuple(OUTMAN_DETAIL_FIELDS(Type, __VA_ARGS__)); \
+            } \
+        }; \
+    }
+
+// Up to 64 fields. The extra expansion steps keep MSVC's traditional
+// preprocessor from passing __VA_ARGS__ on as a single argument.
+#define OUTMAN_DETAIL_EXPAND(x) x
+#define OUTMAN_DETAIL_CAT(a, b) OUTMAN_DETAIL_CAT_I(a, b)
+#define OUTMAN_DETAIL_CAT_I(a, b) a##b
+#define OUTMAN_DETAIL_FIELD(Type, name) ::outman::MakeRecordField(#name, &Type::name)
+#define OUTMAN_DETAIL_FIELDS(Type, ...) \
+    OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_CAT(OUTMAN_DETAIL_FIELDS_, OUTMAN_DETAIL_COUNT(__VA_ARGS__))(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_COUNT(...) OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_COUNT_N(__VA_ARGS__, 64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define OUTMAN_DETAIL_COUNT_N(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, _33, _34, _35, _36, _37, _38, _39, _40, _41, _42, _43, _44, _45, _46, _47, _48, _49, _50, _51, _52, _53, _54, _55, _56, _57, _58, _59, _60, _61, _62, _63, _64, N, ...) N
+#define OUTMAN_DETAIL_FIELDS_1(Type, a) OUTMAN_DETAIL_FIELD(Type, a)
+#define OUTMAN_DETAIL_FIELDS_2(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_1(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_3(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_2(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_4(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_3(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_5(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_4(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_6(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_5(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_7(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_6(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_8(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_7(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_9(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_8(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_10(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_9(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_11(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_10(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_12(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_11(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_13(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_12(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_14(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_13(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_15(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_14(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_16(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_15(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_17(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_16(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_18(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_17(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_19(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_18(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_20(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_19(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_21(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_20(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_22(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_21(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_23(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_22(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_24(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_23(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_25(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_24(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_26(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_25(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_27(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_26(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_28(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_27(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_29(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_28(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_30(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_29(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_31(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_30(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_32(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_31(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_33(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_32(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_34(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_33(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_35(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_34(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_36(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_35(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_37(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_36(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_38(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_37(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_39(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_38(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_40(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_39(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_41(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_40(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_42(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_41(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_43(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_42(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_44(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_43(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_45(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_44(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_46(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_45(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_47(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_46(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_48(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_47(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_49(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_48(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_50(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_49(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_51(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_50(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_52(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_51(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_53(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_52(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_54(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_53(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_55(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_54(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_56(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_55(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_57(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_56(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_58(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_57(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_59(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_58(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_60(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_59(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_61(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_60(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_62(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_61(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_63(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_62(Type, __VA_ARGS__))
+#define OUTMAN_DETAIL_FIELDS_64(Type, a, ...) OUTMAN_DETAIL_FIELD(Type, a), OUTMAN_DETAIL_EXPAND(OUTMAN_DETAIL_FIELDS_63(Type, __VA_ARGS__))
+
+#endif  // OUTMAN_RECORD_FIELDS_HPP
@@ -0,0 +1,328 @@
+#ifndef OUTMAN_RECORD_SERIALIZERS_HPP
+#define OUTMAN_RECORD_SERIALIZERS_HPP
+
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "record_fields.hpp"
+
+// Serializers for records described with OUTMAN_RECORD_FIELDS. Numbers are
+// formatted with std::to_chars straight into the output, with no iostreams,
+// no locale and no allocation per field. Each one offers:
+//
+//     MaxSize(record)        an upper bound of the bytes Write produces
+//     Write(out, record)     writes into a caller-supplied buffer of at
+//                            least MaxSize bytes, returns the end
+//     operator()(buffer, r)  appends to a std::string, as RecordAppender
+//
+// Fields may be integers, bools, enums (as their underlying integer),
+// float, double, std::string or std::string_view.
+namespace outman {
+    namespace detail {
+        template <typename TValue>
+        inline constexpr bool kIsTextField = std::is_same_v<TValue, std::string> || std::is_same_v<TValue, std::string_view>;
+
+        template <typename TValue>
+        inline constexpr bool kIsSerializableField = (std::is_arithmetic_v<TValue> && !std::is_same_v<TValue, long double>)
+            || std::is_enum_v<TValue> || kIsTextField<TValue>;
+
+        // Longest to_chars output of a number: 20 digits and a sign for
+        // 64-bit integers, 24 characters for the shortest round-trip double.
+        constexpr std::size_t kMaxNumberLength = 32;
+
+        template <typename TValue>
+        char* WriteNumber(char* out, TValue value) {
+            if constexpr (std::is_enum_v<TValue>) {
+                return WriteNumber(out, static_cast<std::underlying_type_t<TValue>>(value));
+            }
+            else if constexpr (std::is_same_v<TValue, bool>) {
+                *out = value ? '1' : '0';
+                return out + 1;
+            }
+#if !defined(__cpp_lib_to_chars)
+            // Standard libraries without floating-point to_chars.
+            else if constexpr (std::is_floating_point_v<TValue>) {
+                int size = std::snprintf(out, kMaxNumberLength, "%.*g", std::numeric_limits<TValue>::max_digits10, static_cast<double>(value));
+                return out + size;
+            }
+#endif
+            else {
+                return std::to_chars(out, out + kMaxNumberLength, value).ptr;
+            }
+        }
+
+        template <typename TData>
+        void CheckSerializable() {
+            static_assert(kHasRecordFields<TData>, "record serializers need OUTMAN_RECORD_FIELDS for the record type");
+            ForEachRecordField<TData>([](const auto& field) {
+                using Value = typename std::decay_t<decltype(field)>::Value;
+                static_assert(kIsSerializableField<Value>, "unsupported field type for record serializers");
+            });
+        }
+
+        // Small records are written to the stack and copied once; larger
+        // ones straight into the grown buffer.
+        template <typename TSerializer, typename TData>
+        void AppendSerialized(std::string& buffer, const TData& record) {
+            std::size_t bound = TSerializer::MaxSize(record);
+            constexpr std::size_t kStackSize = 4096;
+            if (bound <= kStackSize) {
+                char scratch[kStackSize];
+                char* end = TSerializer::Write(scratch, record);
+                buffer.append(scratch, static_cast<std::size_t>(end - scratch));
+                return;
+            }
+            std::size_t start = buffer.size();
+            buffer.resize(start + bound);
+            char* end = TSerializer::Write(&buffer[start], record);
+            buffer.resize(static_cast<std::size_t>(end - buffer.data()));
+        }
+    }
+
+    // One line per record: fields in declaration order, comma-separated,
+    // text quoted per RFC 4180 when it holds a comma, quote or line break.
+    template <typename TData>
+    struct CsvRecordAppender {
+        static std::size_t MaxSize(const TData& record) {
+            detail::CheckSerializable<TData>();
+            std::size_t size = 1;
+            ForEachRecordField<TData>([&](const auto& field) {
+                using Value = typename std::decay_t<decltype(field)>::Value;
+                if constexpr (detail::kIsTextField<Value>) {
+                    size += 2 * std::string_view(field.Get(record)).size() + 3;
+                }
+                else {
+                    size += detail::kMaxNumberLength + 1;
+                }
+            });
+            return size;
+        }
+
+        static char* Write(char* out, const TData& record) {
+            bool first = true;
+            ForEachRecordField<TData>([&](const auto& field) {
+                using Value = typename std::decay_t<decltype(field)>::Value;
+                if (!first) {
+                    *out++ = ',';
+                }
+                first = false;
+                if constexpr (detail::kIsTextField<Value>) {
+                    out = WriteText(out, field.Get(record));
+                }
+                else {
+                    out = detail::WriteNumber(out, field.Get(record));
+                }
+            });
+            *out++ = '\n';
+            return out;
+        }
+
+        // The column names as a CSV line.
+        static std::string Header() {
+            std::string header;
+            ForEachRecordField<TData>([&](const auto& field) {
+                if (!header.empty()) {
+                    header.push_back(',');
+                }
+                header += field.name;
+            });
+            header.push_back('\n');
+            return header;
+        }
+
+        void operator()(std::string& buffer, const TData& record) const {
+            detail::AppendSerialized<CsvRecordAppender>(buffer, record);
+        }
+
+    private:
+        static char* WriteText(char* out, std::string_view text) {
+            if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+                std::memcpy(out, text.data(), text.size());
+                return out + text.size();
+            }
+            *out++ = '"';
+            for (char c : text) {
+                if (c == '"') {
+                    *out++ = '"';
+                }
+                *out++ = c;
+            }
+            *out++ = '"';
+            return out;
+        }
+    };
+
+    // One JSON object per line, keyed by field name. Bools are true/false,
+    // NaN and infinities (which JSON cannot express) become null, and text
+    // is escaped as JSON requires; UTF-8 passes through unchanged.
+    template <typename TData>
+    struct JsonLinesRecordAppender {
+        static std::size_t MaxSize(const TData& record) {
+            detail::CheckSerializable<TData>();
+            std::size_t size = 3;
+            ForEachRecordField<TData>([&](const auto& field) {
+                using Value = typename std::decay_t<decltype(field)>::Value;
+                size += std::strlen(field.name) + 4;
+                if constexpr (detail::kIsTextField<Value>) {
+                    size += 6 * std::string_view(field.Get(record)).size() + 2;
+                }
+                else {
+                    size += detail::kMaxNumberLength;
+                }
+            });
+            return size;
+        }
+
+        static char* Write(char* out, const TData& record) {
+            *out++ = '{';
+            bool first = true;
+            ForEachRecordField<TData>([&](const auto& field) {
+                using Value = typename std::decay_t<decltype(field)>::Value;
+                if (!first) {
+                    *out++ = ',';
+                }
+                first = false;
+                *out++ = '"';
+                std::size_t name_size = std::strlen(field.name);
+                std::memcpy(out, field.name, name_size);
+                out += name_size;
+                *out++ = '"';
+                *out++ = ':';
+
+                const auto& value = field.Get(record);
+                if constexpr (detail::kIsTextField<Value>) {
+                    out = WriteText(out, value);
+                }
+                else if constexpr (std::is_same_v<Value, bool>) {
+                    std::memcpy(out, value ? "true" : "false", value ? 4 : 5);
+                    out += value ? 4 : 5;
+                }
+                else if constexpr (std::is_floating_point_v<Value>) {
+                    if (std::isfinite(value)) {
+                        out = detail::WriteNumber(out, value);
+                    }
+                    else {
+                        std::memcpy(out, "null", 4);
+                        out += 4;
+                    }
+                }
+                else {
+                    out = detail::WriteNumber(out, value);
+                }
+            });
+            *out++ = '}';
+            *out++ = '\n';
+            return out;
+        }
+
+        void operator()(std::string& buffer, const TData& record) const {
+            detail::AppendSerialized<JsonLinesRecordAppender>(buffer, record);
+        }
+
+    private:
+        static char* WriteText(char* out, std::string_view text) {
+            static constexpr char kHex[] = "0123456789abcdef";
+            *out++ = '"';
+            for (char c : text) {
+                auto byte = static_cast<unsigned char>(c);
+                if (c == '"' || c == '\\') {
+                    *out++ = '\\';
+                    *out++ = c;
+                }
+                else if (c == '\n') {
+                    *out++ = '\\';
+                    *out++ = 'n';
+                }
+                else if (c == '\t') {
+                    *out++ = '\\';
+                    *out++ = 't';
+                }
+                else if (c == '\r') {
+                    *out++ = '\\';
+                    *out++ = 'r';
+                }
+                else if (byte < 0x20) {
+                    std::memcpy(out, "\\u00", 4);
+                    out[4] = kHex[byte >> 4];
+                    out[5] = kHex[byte & 0xf];
+                    out += 6;
+                }
+                else {
+                    *out++ = c;
+                }
+            }
+            *out++ = '"';
+            return out;
+        }
+    };
+
+    // Fields packed in declaration order with no padding and no separator:
+    // numbers little-endian at their own width (bools one byte), text as a
+    // u32 length and its bytes. Unlike BinaryRecordAppender the layout does
+    // not depend on the compiler, and records may hold text.
+    template <typename TData>
+    struct PackedRecordAppender {
+        static std::size_t MaxSize(const TData& record) {
+            detail::CheckSerializable<TData>();
+            std::size_t size = 0;
+            ForEachRecordField<TData>([&](const auto& field) {
+                using Value = typename std::decay_t<decltype(field)>::Value;
+                if constexpr (detail::kIsTextField<Value>) {
+                    size += 4 + std::string_view(field.Get(record)).size();
+                }
+                else {
+                    size += sizeof(Value);
+                }
+            });
+            return size;
+        }
+
+        static char* Write(char* out, const TData& record) {
+            ForEachRecordField<TData>([&](const auto& field) {
+                using Value = typename std::decay_t<decltype(field)>::Value;
+                const auto& value = field.Get(record);
+                if constexpr (detail::kIsTextField<Value>) {
+                    std::string_view text = value;
+                    out = WriteLittleEndian(out, static_cast<std::uint32_t>(text.size()));
+                    std::memcpy(out, text.data(), text.size());
+                    out += text.size();
+                }
+                else if constexpr (std::is_enum_v<Value>) {
+                    out = WriteLittleEndian(out, static_cast<std::underlying_type_t<Value>>(value));
+                }
+                else {
+                    out = WriteLittleEndian(out, value);
+                }
+            });
+            return out;
+        }
+
+        void operator()(std::string& buffer, const TData& record) const {
+            detail::AppendSerialized<PackedRecordAppender>(buffer, record);
+        }
+
+    private:
+        template <typename TValue>
+        static char* WriteLittleEndian(char* out, TValue value) {
+            using Bits = std::conditional_t<sizeof(TValue) == 1, std::uint8_t,
+                std::conditional_t<sizeof(TValue) == 2, std::uint16_t,
+                std::conditional_t<sizeof(TValue) == 4, std::uint32_t, std::uint64_t>>>;
+            Bits bits;
+            std::memcpy(&bits, &value, sizeof(TValue));
+            for (std::size_t i = 0; i < sizeof(TValue); ++i) {
+                out[i] = static_cast<char>((bits >> (8 * i)) & 0xff);
+            }
+            return out + sizeof(TValue);
+        }
+    };
+}
+
+#endif  // OUTMAN_RECORD_SERIALIZERS_HPP
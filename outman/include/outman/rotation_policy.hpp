@@ -0,0 +1,26 @@
+#ifndef OUTMAN_ROTATION_POLICY_HPP
+#define OUTMAN_ROTATION_POLICY_HPP
+
+#include <chrono>
+#include <cstdint>
+
+namespace outman {
+    // When a rotating file sink closes its segment and starts the next one.
+    // A limit of 0 is disabled; the segment rolls as soon as any enabled
+    // limit is reached, after the record that reached it.
+    struct RotationPolicy {
+        std::uint64_t max_bytes = 0;
+        std::uint64_t max_records = 0;
+        // Wall-clock period; segments end on its multiples since the epoch,
+        // so hourly segments roll on the hour (UTC).
+        std::chrono::seconds period{ 0 };
+
+        // Gzip closed segments in the background. Needs zlib (the CMake
+        // target defines OUTMAN_WITH_ZLIB when it finds it).
+        bool compress = false;
+        // zlib level from 1 (fastest) to 9 (smallest); -1 for zlib's default.
+        int compression_level = -1;
+    };
+}
+
+#endif  // OUTMAN_ROTATION_POLICY_HPP
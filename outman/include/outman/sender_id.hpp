@@ -0,0 +1,146 @@
+#ifndef OUTMAN_SENDER_ID_HPP
+#define OUTMAN_SENDER_ID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace outman {
+    // Who submitted a record or a log message. A sender is a small interned
+    // integer, so it costs nothing to copy into every queued record; its
+    // name is only looked up where text is needed, such as log prefixes.
+    // Register a name once per producer and keep the id.
+    class SenderId {
+    public:
+        using ValueType = std::uint32_t;
+
+        // The anonymous sender.
+        constexpr SenderId() = default;
+
+        constexpr explicit SenderId(ValueType value) : _value(value) {}
+
+        // Interns `name`: registering the same name again returns the same id.
+        static SenderId Register(std::string_view name);
+
+        // Sender of what the manager submits itself, e.g. flushes. Named "outman".
+        static constexpr SenderId Manager() {
+            return SenderId(1);
+        }
+
+        constexpr ValueType Value() const {
+            return _value;
+        }
+
+        constexpr bool IsAnonymous() const {
+            return _value == 0;
+        }
+
+        // Registered name; empty for the anonymous sender.
+        const std::string& Name() const;
+
+        friend constexpr bool operator==(SenderId a, SenderId b) {
+            return a._value == b._value;
+        }
+
+        friend constexpr bool operator!=(SenderId a, SenderId b) {
+            return a._value != b._value;
+        }
+
+        friend constexpr bool operator<(SenderId a, SenderId b) {
+            return a._value < b._value;
+        }
+
+    private:
+        ValueType _value = 0;
+    };
+
+    // Process-wide name table behind SenderId. Ids are dense, starting at 0
+    // for the anonymous sender, so per-sender state can live in a plain
+    // array indexed by SenderId::Value(). Names are never removed.
+    class SenderRegistry {
+    public:
+        static SenderRegistry& Instance() {
+            static SenderRegistry registry;
+            return registry;
+        }
+
+        SenderRegistry(const SenderRegistry&) = delete;
+        SenderRegistry& operator=(const SenderRegistry&) = delete;
+
+        SenderId Register(std::string_view name) {
+            std::string key(name);
+            {
+                std::shared_lock<std::shared_mutex> lock(_mutex);
+                auto it = _ids.find(key);
+                if (it != _ids.end()) {
+                    return it->second;
+                }
+            }
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            auto it = _ids.find(key);
+            if (it != _ids.end()) {
+                return it->second;
+            }
+            if (_names.size() > std::numeric_limits<SenderId::ValueType>::max()) {
+                throw std::length_error("outman: too many registered senders");
+            }
+            SenderId id(static_cast<SenderId::ValueType>(_names.size()));
+            _names.push_back(key);
+            _ids.emplace(std::move(key), id);
+            return id;
+        }
+
+        // Unknown ids get the empty name, like the anonymous sender.
+        const std::string& Name(SenderId id) const {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            // Elements of a deque stay put as it grows, so the reference
+            // outlives the lock.
+            return id.Value() < _names.size() ? _names[id.Value()] : _names.front();
+        }
+
+        // Number of ids handed out so far, the anonymous sender included.
+        std::size_t Size() const {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            return _names.size();
+        }
+
+    private:
+        SenderRegistry() {
+            _names.emplace_back();
+            _ids.emplace(std::string(), SenderId());
+            _names.emplace_back("outman");
+            _ids.emplace("outman", SenderId::Manager());
+        }
+
+        mutable std::shared_mutex _mutex;
+        std::deque<std::string> _names;
+        std::unordered_map<std::string, SenderId> _ids;
+    };
+
+    inline SenderId SenderId::Register(std::string_view name) {
+        return SenderRegistry::Instance().Register(name);
+    }
+
+    inline const std::string& SenderId::Name() const {
+        return SenderRegistry::Instance().Name(*this);
+    }
+}
+
+namespace std {
+    template <>
+    struct hash<outman::SenderId> {
+        std::size_t operator()(outman::SenderId id) const noexcept {
+            return std::hash<outman::SenderId::ValueType>()(id.Value());
+        }
+    };
+}
+
+#endif  // OUTMAN_SENDER_ID_HPP
@@ -0,0 +1,30 @@
+#ifndef OUTMAN_SHUTDOWN_HPP
+#define OUTMAN_SHUTDOWN_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace outman {
+    // Outcome of OutputManager::Shutdown.
+    struct ShutdownReport {
+        // Every record accepted before intake stopped reached its strategies
+        // before the deadline.
+        bool drained = false;
+        // Records still waiting in strategy queues or ingestion rings when
+        // Shutdown returned. A record queued for two strategies counts twice.
+        std::size_t unwritten = 0;
+        // Saves refused so far because intake had stopped.
+        std::uint64_t rejected = 0;
+        std::chrono::milliseconds elapsed{ 0 };
+    };
+
+    // Reported to save completions for records submitted after Shutdown.
+    class OutputStoppedError : public std::runtime_error {
+    public:
+        OutputStoppedError() : std::runtime_error("output manager is shutting down") {}
+    };
+}
+
+#endif  // OUTMAN_SHUTDOWN_HPP
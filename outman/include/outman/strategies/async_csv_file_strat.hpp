@@ -1,21 +1,39 @@
 #pragma once
 
+#include <mutex>
 #include <string>
-#include <fstream>
+#include <string_view>
+#include <type_traits>
 #include "outman/strategies/isaving_strategy.hpp"
-#include "outman/outman.hpp"
+#include "outman/detail/file_handle.hpp"
+#include "outman/record_appender.hpp"
 
+// Writes every record to the file as soon as it is saved, with one write
+// on a descriptor kept open. Use BufferedFileStrat to batch records, and
+// wrap it in AsyncSaveStratLogs to log its calls.
 template <typename TData>
 class AsyncCsvFileStrat : public IAsyncSavingStrategy<TData> {
 public:
-    AsyncCsvFileStrat(const std::string& file_name) : file_name_(file_name) {}
+    AsyncCsvFileStrat(const std::string& file_name)
+        : file_name_(file_name), file_(file_name) {}
 
-    void SaveAsync(const TData& data, const void* sender) override { 
-        outman::om::Log("SaveAsync", static_cast<const void*>(&file_name_));
-        std::ofstream file(file_name_, std::ios_base::app);
-        file << data << std::endl;
+    void SaveAsync(const TData& data, outman::SenderId /*sender*/) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if constexpr (std::is_convertible_v<const TData&, std::string_view>) {
+            std::string_view text = data;
+            outman::detail::WriteChunk chunks[] = { { text.data(), text.size() }, { "\n", 1 } };
+            file_.WriteV(chunks, 2);
+        }
+        else {
+            line_.clear();
+            outman::RecordAppender<TData>()(line_, data);
+            file_.Write(line_.data(), line_.size());
+        }
     }
 
 private:
     std::string file_name_;
+    outman::detail::FileHandle file_;
+    std::string line_;
+    std::mutex mutex_;
 };
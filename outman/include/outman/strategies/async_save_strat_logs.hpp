@@ -10,7 +10,7 @@ public:
                        std::shared_ptr<IOutLogger> logger)
         : inner_strategy_(inner_strategy), logger_(logger) {}
 
-    void SaveAsync(const TData& data, const void* sender) override {
+    void SaveAsync(const TData& data, outman::SenderId sender) override {
         inner_strategy_->SaveAsync(data, sender);
         logger_->Log("Data saved", sender);
     }
@@ -4,16 +4,18 @@
 #include "isaving_strategy.hpp"
 #include "outman/output_manager.hpp"
 
+// A synchronous Save that the manager runs off the producer's thread, in
+// the strategy's own lane. SaveAsync is only for callers outside a manager
+// and saves on the calling thread.
 template <typename TData>
 class BaseSavingStrategy : public IWrappedSyncSavingStrategy<TData> {
 public:
     virtual ~BaseSavingStrategy() = default;
 
-    virtual void Save(const TData& data, const void* sender) override = 0;
+    virtual void Save(const TData& data, outman::SenderId sender) override = 0;
 
-    virtual void SaveAsync(const TData& data, const void* sender) override {
-        // Use the thread pool from OutputManager to execute Save
-        boost::asio::post(outman::OutputManager::Instance()._thread_pool, [=] { Save(data, sender); });
+    virtual void SaveAsync(const TData& data, outman::SenderId sender) override {
+        Save(data, sender);
     }
 };
 
@@ -22,9 +24,9 @@ class BaseAsyncSavingStrategy : public IAsyncSavingStrategy<TData> {
 public:
     virtual ~BaseAsyncSavingStrategy() = default;
 
-    virtual void SaveAsync(const TData& data, const void* sender) override = 0;
+    virtual void SaveAsync(const TData& data, outman::SenderId sender) override = 0;
 
-    virtual void Save(const TData& data, const void* sender) {
+    virtual void Save(const TData& data, outman::SenderId sender) {
         SaveAsync(data, sender); // Synchronous call
     }
 };
@@ -34,10 +36,10 @@ class BaseFlushableSavingStrategy : public IFlushableSavingStrategy<TData> {
 public:
     virtual ~BaseFlushableSavingStrategy() = default;
 
-    virtual void AddAsync(const TData& data, const void* sender) override = 0;
-    virtual void FlushAsync(const void* sender) override = 0;
+    virtual void AddAsync(const TData& data, outman::SenderId sender) override = 0;
+    virtual void FlushAsync(outman::SenderId sender) override = 0;
 
-    virtual void Save(const TData& data, const void* sender) override {
+    virtual void Save(const TData& data, outman::SenderId sender) override {
         AddAsync(data, sender);
         FlushAsync(sender);
     }
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "base_saving_strategy.hpp"
+#include "group_commit_strategy.hpp"
+#include "../detail/file_handle.hpp"
+#include "../detail/group_committer.hpp"
+#include "../record_appender.hpp"
+#include "../sync_policy.hpp"
+
+// Appends records to a file through one descriptor kept open for the
+// strategy's lifetime. Records are formatted by outman::RecordAppender
+// into a user-space buffer that goes out in one write when it fills up or
+// on FlushAsync, so register it with AddFlushableStrategy and a
+// FlushPolicy (or RegisterFlushableStrategy) to choose when data reaches
+// the file. Text records of at least a quarter of the buffer skip the
+// copy and go out together with the buffered ones in a single writev.
+//
+// The outman::SyncPolicy decides when the file is fdatasync'ed; records
+// with a completion then complete once a sync covers them.
+template <typename TData>
+class BufferedFileStrat : public BaseFlushableSavingStrategy<TData>, public IGroupCommitStrategy {
+public:
+    static constexpr std::size_t kDefaultBufferSize = std::size_t(1) << 20;
+
+    explicit BufferedFileStrat(
+        const std::string& file_name,
+        std::size_t buffer_size = kDefaultBufferSize,
+        const outman::SyncPolicy& sync_policy = outman::SyncPolicy::None()
+    )
+        : file_name_(file_name), file_(file_name), buffer_size_(buffer_size ? buffer_size : kDefaultBufferSize),
+        committer_(sync_policy, mutex_, [this]() { WriteBufferLocked(); }, [this]() { file_.Sync(); }) {
+        buffer_.reserve(buffer_size_);
+    }
+
+    ~BufferedFileStrat() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            try {
+                WriteBufferLocked();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "BufferedFileStrat: " << file_name_ << ": " << e.what() << std::endl;
+            }
+        }
+        committer_.Commit();
+    }
+
+    void AddAsync(const TData& data, outman::SenderId) override {
+        bool commit_now;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            commit_now = committer_.Added(AppendLocked(data));
+        }
+        if (commit_now) {
+            committer_.Commit();
+        }
+    }
+
+    void FlushAsync(outman::SenderId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        WriteBufferLocked();
+    }
+
+    const std::string& FileName() const {
+        return file_name_;
+    }
+
+    void WhenCommitted(std::function<void(std::exception_ptr)> done) override {
+        committer_.WhenCommitted(std::move(done));
+    }
+
+    void Commit() override {
+        committer_.Commit();
+    }
+
+    std::chrono::milliseconds CommitCheckInterval() const override {
+        return committer_.CheckInterval();
+    }
+
+    void CommitIfDue(std::chrono::steady_clock::time_point now) override {
+        committer_.CommitIfDue(now);
+    }
+
+private:
+    // Returns the record's size in the file.
+    std::size_t AppendLocked(const TData& data) {
+        if constexpr (std::is_convertible_v<const TData&, std::string_view>) {
+            std::string_view text = data;
+            if (text.size() >= buffer_size_ / 4) {
+                outman::detail::WriteChunk chunks[] = {
+                    { buffer_.data(), buffer_.size() },
+                    { text.data(), text.size() },
+                    { "\n", 1 }
+                };
+                WriteLocked(chunks, 3);
+                return text.size() + 1;
+            }
+        }
+        std::size_t before = buffer_.size();
+        outman::RecordAppender<TData>()(buffer_, data);
+        std::size_t added = buffer_.size() - before;
+        if (buffer_.size() >= buffer_size_) {
+            WriteBufferLocked();
+        }
+        return added;
+    }
+
+    void WriteBufferLocked() {
+        if (!buffer_.empty()) {
+            outman::detail::WriteChunk chunk{ buffer_.data(), buffer_.size() };
+            WriteLocked(&chunk, 1);
+        }
+    }
+
+    // The buffer is emptied even when the write fails: the error is
+    // reported to the caller and the next records start clean.
+    void WriteLocked(const outman::detail::WriteChunk* chunks, std::size_t count) {
+        try {
+            file_.WriteV(chunks, count);
+        }
+        catch (...) {
+            buffer_.clear();
+            throw;
+        }
+        buffer_.clear();
+    }
+
+    std::string file_name_;
+    outman::detail::FileHandle file_;
+    const std::size_t buffer_size_;
+    std::string buffer_;
+    std::mutex mutex_;
+    outman::detail::GroupCommitter committer_;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "base_saving_strategy.hpp"
+#include "../block_compression_sink.hpp"
+#include "../byte_sink.hpp"
+#include "../record_appender.hpp"
+
+// Formats records with TAppender and hands the bytes to an outman::IByteSink
+// in buffer-sized writes, so output can go through stages before it lands
+// in a file. A gzip-compressed CSV whose blocks are compressed in parallel
+// on the manager's workers:
+//
+//     auto file = std::make_shared<outman::FileByteSink>("out.csv.gz");
+//     auto codec = std::make_shared<outman::GzipBlockCodec>(1);
+//     auto gzip = std::make_shared<outman::BlockCompressionSink>(file, codec);
+//     manager.AddFlushableStrategy<Row>(std::make_shared<ByteSinkStrat<Row>>(gzip), policy);
+//
+// FlushAsync flushes the whole chain, so flush on a FlushPolicy with large
+// thresholds: every flush ends a compressed block early.
+template <typename TData, typename TAppender = outman::RecordAppender<TData>>
+class ByteSinkStrat : public BaseFlushableSavingStrategy<TData>, public IExecutorBoundStrategy {
+public:
+    static constexpr std::size_t kDefaultBufferSize = std::size_t(64) << 10;
+
+    explicit ByteSinkStrat(std::shared_ptr<outman::IByteSink> sink, std::size_t buffer_size = kDefaultBufferSize)
+        : sink_(std::move(sink)), buffer_size_(buffer_size ? buffer_size : kDefaultBufferSize) {
+        buffer_.reserve(buffer_size_);
+    }
+
+    ~ByteSinkStrat() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try {
+            WriteBufferLocked();
+            sink_->Flush();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "ByteSinkStrat: " << e.what() << std::endl;
+        }
+    }
+
+    void AddAsync(const TData& data, outman::SenderId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        TAppender()(buffer_, data);
+        if (buffer_.size() >= buffer_size_) {
+            WriteBufferLocked();
+        }
+    }
+
+    void FlushAsync(outman::SenderId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        WriteBufferLocked();
+        sink_->Flush();
+    }
+
+    void BindExecutor(const boost::asio::any_io_executor& executor) override {
+        sink_->BindExecutor(executor);
+    }
+
+    const std::shared_ptr<outman::IByteSink>& Sink() const {
+        return sink_;
+    }
+
+private:
+    // The buffer is emptied even when the write fails, as in BufferedFileStrat.
+    void WriteBufferLocked() {
+        if (buffer_.empty()) {
+            return;
+        }
+        try {
+            sink_->Write(buffer_.data(), buffer_.size());
+        }
+        catch (...) {
+            buffer_.clear();
+            throw;
+        }
+        buffer_.clear();
+    }
+
+    std::shared_ptr<outman::IByteSink> sink_;
+    const std::size_t buffer_size_;
+    std::string buffer_;
+    std::mutex mutex_;
+};
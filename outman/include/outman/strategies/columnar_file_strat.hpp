@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base_saving_strategy.hpp"
+#include "../columnar_format.hpp"
+#include "../detail/columnar_encoding.hpp"
+#include "../detail/file_handle.hpp"
+#include "../record_fields.hpp"
+
+// Writes struct records as a columnar file (see columnar_format.hpp), so
+// readers such as outman::ColumnarFileReader fetch only the columns they
+// need and never parse text. TData needs OUTMAN_RECORD_FIELDS; fields may
+// be integers, bools, enums, float, double or std::string.
+//
+// Rows are buffered until `row_group_size` of them (or a flush) make a row
+// group; the group is then transposed into one chunk per column, each
+// encoded on its own (ColumnEncoding::Auto picks per chunk, or set one per
+// field name) with min/max statistics. Every row group is followed by a
+// fresh footer, which the next one overwrites, so the file is complete
+// after every write. Small row groups compress poorly: flush rarely.
+//
+// An existing file of the same name is replaced.
+template <typename TData>
+class ColumnarFileStrat : public BaseFlushableSavingStrategy<TData> {
+    static_assert(outman::kHasRecordFields<TData>, "ColumnarFileStrat needs OUTMAN_RECORD_FIELDS for the record type");
+
+public:
+    static constexpr std::size_t kDefaultRowGroupSize = 64 * 1024;
+
+    explicit ColumnarFileStrat(
+        const std::string& file_name,
+        std::size_t row_group_size = kDefaultRowGroupSize,
+        const std::map<std::string, outman::ColumnEncoding>& encodings = {}
+    )
+        : file_name_(file_name), file_(file_name, O_TRUNC), row_group_size_(row_group_size ? row_group_size : kDefaultRowGroupSize) {
+        std::size_t matched = 0;
+        outman::ForEachRecordField<TData>([&](const auto& field) {
+            using Value = typename std::decay_t<decltype(field)>::Value;
+            static_assert(outman::ColumnTypeOf<Value>() != outman::ColumnType::Unsupported,
+                "ColumnarFileStrat: unsupported field type");
+            auto encoding = outman::ColumnEncoding::Auto;
+            auto it = encodings.find(field.name);
+            if (it != encodings.end()) {
+                encoding = it->second;
+                ++matched;
+                if (!outman::SupportsEncoding<Value>(encoding)) {
+                    throw std::invalid_argument(std::string("ColumnarFileStrat: encoding does not apply to field ") + field.name);
+                }
+            }
+            meta_.columns.push_back({ field.name, outman::ColumnTypeOf<Value>() });
+            encodings_.push_back(encoding);
+        });
+        if (matched != encodings.size()) {
+            throw std::invalid_argument("ColumnarFileStrat: encoding given for an unknown field");
+        }
+        rows_.reserve(row_group_size_);
+
+        file_.WriteAt(outman::kColumnarMagic, sizeof(outman::kColumnarMagic), 0);
+        data_end_ = sizeof(outman::kColumnarMagic);
+        WriteFooterLocked();
+    }
+
+    ~ColumnarFileStrat() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try {
+            WriteRowGroupLocked();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "ColumnarFileStrat: " << file_name_ << ": " << e.what() << std::endl;
+        }
+    }
+
+    void AddAsync(const TData& data, outman::SenderId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rows_.push_back(data);
+        if (rows_.size() >= row_group_size_) {
+            WriteRowGroupLocked();
+        }
+    }
+
+    void FlushAsync(outman::SenderId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        WriteRowGroupLocked();
+    }
+
+    const std::string& FileName() const {
+        return file_name_;
+    }
+
+private:
+    // The rows are dropped even when the write fails, and the footer then
+    // still describes the file as it was.
+    void WriteRowGroupLocked() {
+        if (rows_.empty()) {
+            return;
+        }
+        outman::detail::RowGroupMeta group;
+        group.rows = rows_.size();
+        group_.clear();
+        std::size_t column = 0;
+        outman::ForEachRecordField<TData>([&](const auto& field) {
+            using Value = typename std::decay_t<decltype(field)>::Value;
+            std::vector<Value> values;
+            values.reserve(rows_.size());
+            for (const auto& row : rows_) {
+                values.push_back(field.Get(row));
+            }
+
+            outman::detail::ColumnChunkMeta chunk;
+            chunk.offset = data_end_ + group_.size();
+            chunk.encoding = outman::detail::EncodeColumn(encodings_[column++], values, group_);
+            chunk.size = data_end_ + group_.size() - chunk.offset;
+            Value min{};
+            Value max{};
+            chunk.has_stats = outman::detail::ColumnMinMax(values, min, max);
+            if (chunk.has_stats) {
+                outman::detail::PutPlain(chunk.min, min);
+                outman::detail::PutPlain(chunk.max, max);
+            }
+            group.chunks.push_back(std::move(chunk));
+        });
+        rows_.clear();
+
+        file_.WriteAt(group_.data(), group_.size(), data_end_);
+        data_end_ += group_.size();
+        meta_.row_groups.push_back(std::move(group));
+        WriteFooterLocked();
+    }
+
+    void WriteFooterLocked() {
+        footer_.clear();
+        outman::detail::PutFooter(meta_, footer_);
+        file_.WriteAt(footer_.data(), footer_.size(), data_end_);
+        // Drops whatever a failed row group write left behind the footer.
+        file_.Truncate(data_end_ + footer_.size());
+    }
+
+    std::string file_name_;
+    outman::detail::FileHandle file_;
+    const std::size_t row_group_size_;
+    std::vector<outman::ColumnEncoding> encodings_;
+    std::vector<TData> rows_;
+    outman::detail::ColumnarFileMeta meta_;
+    // End of the last row group, where the footer starts.
+    std::uint64_t data_end_ = 0;
+    std::string group_;
+    std::string footer_;
+    std::mutex mutex_;
+};
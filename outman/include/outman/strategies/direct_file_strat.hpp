@@ -0,0 +1,112 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "base_saving_strategy.hpp"
+#include "group_commit_strategy.hpp"
+#include "../detail/direct_file_writer.hpp"
+#include "../detail/group_committer.hpp"
+#include "../record_appender.hpp"
+#include "../sync_policy.hpp"
+
+// File sink for large write-once outputs that should not go through the
+// page cache and evict the working set of everything else on the host.
+// Records are formatted by outman::RecordAppender into two aligned blocks
+// written with O_DIRECT, one filling while the other is written (in the
+// background where io_uring is available).
+//
+// FlushAsync waits until everything added so far is in the file, padding
+// and then truncating the last partial sector, so flush rarely: register
+// it with AddFlushableStrategy and a FlushPolicy with large thresholds.
+// Direct writes still leave the file size and allocation to the journal,
+// so durable output takes an outman::SyncPolicy as well; a commit is a
+// flush followed by fdatasync.
+template <typename TData>
+class DirectFileStrat : public BaseFlushableSavingStrategy<TData>, public IGroupCommitStrategy {
+public:
+    static constexpr std::size_t kDefaultBlockSize = std::size_t(4) << 20;
+
+    explicit DirectFileStrat(
+        const std::string& file_name,
+        std::size_t block_size = kDefaultBlockSize,
+        std::size_t alignment = outman::detail::DirectFileWriter::kDefaultAlignment,
+        const outman::SyncPolicy& sync_policy = outman::SyncPolicy::None()
+    )
+        : file_name_(file_name), writer_(file_name, block_size, alignment),
+        committer_(sync_policy, mutex_, [this]() { writer_.Flush(); }, [this]() { writer_.File().Sync(); }) {}
+
+    ~DirectFileStrat() override {
+        committer_.Commit();
+    }
+
+    void AddAsync(const TData& data, outman::SenderId) override {
+        bool commit_now;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            commit_now = committer_.Added(AppendLocked(data));
+        }
+        if (commit_now) {
+            committer_.Commit();
+        }
+    }
+
+    void FlushAsync(outman::SenderId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writer_.Flush();
+    }
+
+    bool UsesDirectIo() const {
+        return writer_.UsesDirectIo();
+    }
+
+    const std::string& FileName() const {
+        return file_name_;
+    }
+
+    void WhenCommitted(std::function<void(std::exception_ptr)> done) override {
+        committer_.WhenCommitted(std::move(done));
+    }
+
+    void Commit() override {
+        committer_.Commit();
+    }
+
+    std::chrono::milliseconds CommitCheckInterval() const override {
+        return committer_.CheckInterval();
+    }
+
+    void CommitIfDue(std::chrono::steady_clock::time_point now) override {
+        committer_.CommitIfDue(now);
+    }
+
+private:
+    // Returns the record's size in the file.
+    std::size_t AppendLocked(const TData& data) {
+        if constexpr (std::is_convertible_v<const TData&, std::string_view>) {
+            std::string_view text = data;
+            writer_.Append(text.data(), text.size());
+            writer_.Append("\n", 1);
+            return text.size() + 1;
+        }
+        else {
+            line_.clear();
+            outman::RecordAppender<TData>()(line_, data);
+            writer_.Append(line_.data(), line_.size());
+            return line_.size();
+        }
+    }
+
+    std::string file_name_;
+    outman::detail::DirectFileWriter writer_;
+    std::string line_;
+    std::mutex mutex_;
+    outman::detail::GroupCommitter committer_;
+};
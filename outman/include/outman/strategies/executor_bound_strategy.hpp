@@ -0,0 +1,14 @@
+#ifndef EXECUTOR_BOUND_STRATEGY_HPP
+#define EXECUTOR_BOUND_STRATEGY_HPP
+
+#include <boost/asio/any_io_executor.hpp>
+
+// Implemented by strategies that post work of their own. AddStrategy binds
+// them to the executor of the manager they are registered with.
+class IExecutorBoundStrategy {
+public:
+    virtual ~IExecutorBoundStrategy() = default;
+    virtual void BindExecutor(const boost::asio::any_io_executor& executor) = 0;
+};
+
+#endif // EXECUTOR_BOUND_STRATEGY_HPP
@@ -0,0 +1,27 @@
+#ifndef GROUP_COMMIT_STRATEGY_HPP
+#define GROUP_COMMIT_STRATEGY_HPP
+
+#include <chrono>
+#include <exception>
+#include <functional>
+
+// Implemented by sinks that make records durable later than they take
+// them. The manager then completes records only once the sink calls
+// back, and drives the sink's periodic commits from its flush timer.
+class IGroupCommitStrategy {
+public:
+    virtual ~IGroupCommitStrategy() = default;
+
+    // Calls `done` once everything handed to the strategy so far is
+    // durable, or with the error that stopped it. May call it inline.
+    virtual void WhenCommitted(std::function<void(std::exception_ptr)> done) = 0;
+
+    // Commits everything handed over so far and releases its waiters.
+    virtual void Commit() = 0;
+
+    // Period at which the manager calls CommitIfDue; zero for never.
+    virtual std::chrono::milliseconds CommitCheckInterval() const = 0;
+    virtual void CommitIfDue(std::chrono::steady_clock::time_point now) = 0;
+};
+
+#endif // GROUP_COMMIT_STRATEGY_HPP
@@ -3,6 +3,8 @@
 
 #include <memory>
 
+#include "../sender_id.hpp"
+
 class ISavingStrategyBase {
 public:
     virtual ~ISavingStrategyBase() = default;
@@ -12,7 +14,7 @@ template <typename TData>
 class ISavingStrategy : public ISavingStrategyBase {
 public:
     virtual ~ISavingStrategy() = default;
-    virtual void Save(const TData& data, const void* sender) = 0;
+    virtual void Save(const TData& data, outman::SenderId sender) = 0;
 };
 
 template <typename TData>
@@ -20,7 +22,7 @@ class IWrappedSyncSavingStrategy : public ISavingStrategy<TData> {
 public:
     virtual ~IWrappedSyncSavingStrategy() = default;
 
-    virtual void SaveAsync(const TData& data, const void* sender) = 0;
+    virtual void SaveAsync(const TData& data, outman::SenderId sender) = 0;
 };
 
 template <typename TData>
@@ -28,9 +30,9 @@ class IAsyncSavingStrategy : public ISavingStrategy<TData> {
 public:
     virtual ~IAsyncSavingStrategy() = default;
 
-    virtual void SaveAsync(const TData& data, const void* sender) = 0;
+    virtual void SaveAsync(const TData& data, outman::SenderId sender) = 0;
 
-    void Save(const TData& data, const void* sender) override {
+    void Save(const TData& data, outman::SenderId sender) override {
         SaveAsync(data, sender); // You can call SaveAsync directly, or you can provide a different implementation for synchronous saving.
     }
 };
@@ -40,8 +42,8 @@ class IFlushableSavingStrategy : public ISavingStrategy<TData> {
 public:
     virtual ~IFlushableSavingStrategy() = default;
 
-    virtual void AddAsync(const TData& data, const void* sender) = 0;
-    virtual void FlushAsync(const void* sender) = 0;
+    virtual void AddAsync(const TData& data, outman::SenderId sender) = 0;
+    virtual void FlushAsync(outman::SenderId sender) = 0;
 };
 
 #endif // I_SAVING_STRATEGY_HPP
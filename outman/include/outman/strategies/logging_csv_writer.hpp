@@ -11,9 +11,9 @@
 class LoggingCsvFileWriter : public BaseAsyncSavingStrategy<std::string> {
 public:
     explicit LoggingCsvFileWriter(const std::string& file_name, std::shared_ptr<BaseAsyncSavingStrategy<std::string>> strategy)
-        : file_name_(file_name), strategy_(strategy) {}
+        : file_name_(file_name), sender_(outman::SenderId::Register(file_name)), strategy_(strategy) {}
 
-    void SaveAsync(const std::string& data, const void* sender) override {
+    void SaveAsync(const std::string& data, outman::SenderId sender) override {
         auto start_time = std::chrono::system_clock::now();
         auto start_time_c = std::chrono::system_clock::to_time_t(start_time);
         std::thread::id thread_id = std::this_thread::get_id();
@@ -23,7 +23,7 @@ public:
             std::cout << "Saving started at " << std::ctime(&start_time_c) << " in thread " << thread_id << " for file " << file_name_ << std::endl;
         }
 
-        strategy_->SaveAsync(data, this);
+        strategy_->SaveAsync(data, sender_);
 
         auto end_time = std::chrono::system_clock::now();
         auto end_time_c = std::chrono::system_clock::to_time_t(end_time);
@@ -36,6 +36,7 @@ public:
 
 private:
     std::string file_name_;
+    outman::SenderId sender_;
     std::shared_ptr<BaseAsyncSavingStrategy<std::string>> strategy_;
     std::mutex log_mutex_;
 };
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "base_saving_strategy.hpp"
+#include "../detail/mapped_file_writer.hpp"
+#include "../record_appender.hpp"
+
+// Appends records to a file through a sliding memory mapping, so saving a
+// record is a copy into the mapping with no system call. Fixed-size
+// records (e.g. with outman::BinaryRecordAppender) are written in place;
+// other formats go through a line buffer first. FlushAsync applies the
+// MapSyncPolicy; with MapSyncPolicy::Kernel it does nothing and the
+// kernel writes pages back on its own schedule.
+//
+// The file is preallocated one window ahead and truncated to its data
+// when the strategy is destroyed. POSIX only.
+template <typename TData, typename TAppender = outman::RecordAppender<TData>>
+class MappedFileStrat : public BaseFlushableSavingStrategy<TData> {
+public:
+    static constexpr std::size_t kDefaultWindowSize = std::size_t(64) << 20;
+
+    explicit MappedFileStrat(
+        const std::string& file_name,
+        outman::MapSyncPolicy sync_policy = outman::MapSyncPolicy::Kernel,
+        std::size_t window_size = kDefaultWindowSize
+    )
+        : file_name_(file_name), writer_(file_name, window_size, sync_policy) {}
+
+    void AddAsync(const TData& data, outman::SenderId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if constexpr (outman::detail::kHasFixedSize<TAppender>) {
+            char* out = writer_.Reserve(TAppender::kFixedSize);
+            if (out) {
+                TAppender().Write(out, data);
+                writer_.Commit(TAppender::kFixedSize);
+                return;
+            }
+        }
+        if constexpr (std::is_same_v<TAppender, outman::RecordAppender<TData>>
+            && std::is_convertible_v<const TData&, std::string_view>) {
+            std::string_view text = data;
+            writer_.Append(text.data(), text.size());
+            writer_.Append("\n", 1);
+        }
+        else {
+            line_.clear();
+            TAppender()(line_, data);
+            writer_.Append(line_.data(), line_.size());
+        }
+    }
+
+    void FlushAsync(outman::SenderId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writer_.Flush();
+    }
+
+    const std::string& FileName() const {
+        return file_name_;
+    }
+
+private:
+    std::string file_name_;
+    outman::detail::MappedFileWriter writer_;
+    std::string line_;
+    std::mutex mutex_;
+};
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "base_saving_strategy.hpp"
+#include "../detail/background_worker.hpp"
+#include "../detail/file_handle.hpp"
+#include "../detail/gzip_file.hpp"
+#include "../record_appender.hpp"
+#include "../rotation_policy.hpp"
+
+// Writes records into a series of segment files instead of one file that
+// grows forever: "run.csv" becomes run.000001.csv, run.000002.csv and so
+// on, numbered on from the highest segment already on disk. A segment
+// rolls by size, record count or wall-clock period (outman::RotationPolicy).
+//
+// A background thread at idle priority keeps the next segment open ahead
+// of time, so a roll only swaps descriptors on the writer's side. The same
+// thread closes retired segments and, if asked, gzips them into
+// run.000001.csv.gz. Empty segments are removed instead.
+//
+// Records are formatted by TAppender into a buffer as in BufferedFileStrat.
+// FlushAsync writes the buffer out and also rolls a segment whose period
+// is over, so idle segments roll too when the strategy is flushed on a
+// timer. The destructor waits for the background work to finish.
+template <typename TData, typename TAppender = outman::RecordAppender<TData>>
+class RotatingFileStrat : public BaseFlushableSavingStrategy<TData> {
+public:
+    static constexpr std::size_t kDefaultBufferSize = std::size_t(1) << 20;
+
+    RotatingFileStrat(
+        const std::string& file_name,
+        const outman::RotationPolicy& policy,
+        std::size_t buffer_size = kDefaultBufferSize
+    )
+        : file_name_(file_name), policy_(policy), buffer_size_(buffer_size ? buffer_size : kDefaultBufferSize),
+        worker_("outman_rotate") {
+#if !OUTMAN_WITH_ZLIB
+        if (policy_.compress) {
+            throw std::invalid_argument("RotatingFileStrat: compressing segments needs zlib (OUTMAN_WITH_ZLIB)");
+        }
+#endif
+        buffer_.reserve(buffer_size_);
+        std::lock_guard<std::mutex> lock(mutex_);
+        StartLocked(OpenSegment(LastSegmentIndex() + 1));
+    }
+
+    ~RotatingFileStrat() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            try {
+                WriteBufferLocked();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "RotatingFileStrat: " << current_.name << ": " << e.what() << std::endl;
+            }
+            RetireLocked();
+        }
+        {
+            std::lock_guard<std::mutex> lock(next_mutex_);
+            wanted_ = 0;
+        }
+        worker_.WaitIdle();
+
+        // A segment the worker opened ahead before was never used.
+        std::lock_guard<std::mutex> lock(next_mutex_);
+        if (next_) {
+            next_->file.Close();
+            std::remove(next_->name.c_str());
+        }
+    }
+
+    void AddAsync(const TData& data, outman::SenderId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (PeriodOverLocked()) {
+            RollLocked();
+        }
+        std::size_t before = buffer_.size();
+        TAppender()(buffer_, data);
+        segment_bytes_ += buffer_.size() - before;
+        ++segment_records_;
+        if (buffer_.size() >= buffer_size_) {
+            WriteBufferLocked();
+        }
+        if ((policy_.max_bytes > 0 && segment_bytes_ >= policy_.max_bytes)
+            || (policy_.max_records > 0 && segment_records_ >= policy_.max_records)) {
+            RollLocked();
+        }
+    }
+
+    void FlushAsync(outman::SenderId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        WriteBufferLocked();
+        if (PeriodOverLocked()) {
+            RollLocked();
+        }
+    }
+
+    const std::string& FileName() const {
+        return file_name_;
+    }
+
+    std::string CurrentSegmentName() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return current_.name;
+    }
+
+    // Blocks until every retired segment is closed (and compressed).
+    void WaitForBackground() {
+        worker_.WaitIdle();
+    }
+
+private:
+    struct Segment {
+        std::uint64_t index = 0;
+        std::string name;
+        outman::detail::FileHandle file;
+    };
+
+    Segment OpenSegment(std::uint64_t index) const {
+        std::string name = SegmentName(index);
+        outman::detail::FileHandle file(name);
+        return Segment{ index, std::move(name), std::move(file) };
+    }
+
+    std::string SegmentName(std::uint64_t index) const {
+        std::filesystem::path path(file_name_);
+        char number[24];
+        std::snprintf(number, sizeof(number), ".%06llu", static_cast<unsigned long long>(index));
+        return (path.parent_path() / (path.stem().string() + number + path.extension().string())).string();
+    }
+
+    // Highest segment number of this file name on disk, compressed or not.
+    std::uint64_t LastSegmentIndex() const {
+        std::filesystem::path path(file_name_);
+        std::filesystem::path directory = path.parent_path().empty() ? std::filesystem::path(".") : path.parent_path();
+        std::string prefix = path.stem().string() + ".";
+        std::string extension = path.extension().string();
+
+        std::uint64_t last = 0;
+        std::error_code error;
+        for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+            std::string name = it->path().filename().string();
+            if (name.compare(0, prefix.size(), prefix) != 0) {
+                continue;
+            }
+            std::size_t digits = prefix.size();
+            while (digits < name.size() && name[digits] >= '0' && name[digits] <= '9') {
+                ++digits;
+            }
+            std::string rest = name.substr(digits);
+            if (digits == prefix.size() || rest.compare(0, extension.size(), extension) != 0) {
+                continue;
+            }
+            rest.erase(0, extension.size());
+            if (!rest.empty() && rest != ".gz" && rest != ".gz.part") {
+                continue;
+            }
+            // A number too large to continue from is not one of ours.
+            std::uint64_t index = 0;
+            auto parsed = std::from_chars(name.data() + prefix.size(), name.data() + digits, index);
+            if (parsed.ec == std::errc() && index != std::numeric_limits<std::uint64_t>::max()) {
+                last = std::max(last, index);
+            }
+        }
+        return last;
+    }
+
+    bool PeriodOverLocked() const {
+        return policy_.period.count() > 0 && std::chrono::system_clock::now() >= segment_end_;
+    }
+
+    void StartLocked(Segment segment) {
+        current_ = std::move(segment);
+        segment_bytes_ = 0;
+        segment_records_ = 0;
+        if (policy_.period.count() > 0) {
+            auto now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+            segment_end_ = std::chrono::system_clock::time_point((now / policy_.period + 1) * policy_.period);
+        }
+        PrepareNextLocked();
+    }
+
+    void RollLocked() {
+        WriteBufferLocked();
+        Segment next = TakeNextLocked();
+        RetireLocked();
+        StartLocked(std::move(next));
+    }
+
+    void PrepareNextLocked() {
+        std::uint64_t index = current_.index + 1;
+        {
+            std::lock_guard<std::mutex> lock(next_mutex_);
+            wanted_ = index;
+        }
+        worker_.PostUrgent([this, index]() {
+            std::lock_guard<std::mutex> lock(next_mutex_);
+            if (wanted_ == index && !next_) {
+                next_ = OpenSegment(index);
+            }
+        });
+    }
+
+    // The segment opened ahead, or a freshly opened one if the worker has
+    // not got to it yet; it then no longer opens its own.
+    Segment TakeNextLocked() {
+        {
+            std::lock_guard<std::mutex> lock(next_mutex_);
+            wanted_ = 0;
+            if (next_) {
+                Segment next = std::move(*next_);
+                next_.reset();
+                return next;
+            }
+        }
+        return OpenSegment(current_.index + 1);
+    }
+
+    // Hands the current segment to the worker to close and compress.
+    void RetireLocked() {
+        auto retired = std::make_shared<Segment>(std::move(current_));
+        bool empty = segment_bytes_ == 0;
+        bool compress = policy_.compress;
+        int level = policy_.compression_level;
+        worker_.Post([retired, empty, compress, level]() {
+            retired->file.Close();
+            if (empty) {
+                std::remove(retired->name.c_str());
+            }
+#if OUTMAN_WITH_ZLIB
+            else if (compress) {
+                outman::detail::GzipFile(retired->name, retired->name + ".gz", level);
+            }
+#else
+            (void)compress;
+            (void)level;
+#endif
+        });
+    }
+
+    // The buffer is emptied even when the write fails, as in BufferedFileStrat.
+    void WriteBufferLocked() {
+        if (buffer_.empty()) {
+            return;
+        }
+        try {
+            current_.file.Write(buffer_.data(), buffer_.size());
+        }
+        catch (...) {
+            buffer_.clear();
+            throw;
+        }
+        buffer_.clear();
+    }
+
+    std::string file_name_;
+    const outman::RotationPolicy policy_;
+    const std::size_t buffer_size_;
+    std::string buffer_;
+    Segment current_;
+    std::uint64_t segment_bytes_ = 0;
+    std::uint64_t segment_records_ = 0;
+    std::chrono::system_clock::time_point segment_end_;
+    std::mutex mutex_;
+
+    // The segment opened ahead by the worker, and the index it should have.
+    std::optional<Segment> next_;
+    std::uint64_t wanted_ = 0;
+    std::mutex next_mutex_;
+
+    // Last, so it stops before anything its tasks use is destroyed.
+    outman::detail::BackgroundWorker worker_;
+};
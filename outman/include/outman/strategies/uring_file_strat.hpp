@@ -0,0 +1,112 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "base_saving_strategy.hpp"
+#include "group_commit_strategy.hpp"
+#include "../detail/group_committer.hpp"
+#include "../detail/uring_file_writer.hpp"
+#include "../record_appender.hpp"
+#include "../sync_policy.hpp"
+
+// Buffered file sink whose writes do not block the manager's workers:
+// full buffers go to the kernel through io_uring (registered buffers, a
+// fixed file, one submission per buffer) and the worker moves on to the
+// next buffer. Records are formatted by outman::RecordAppender, as in
+// BufferedFileStrat, and FlushAsync starts writing whatever is buffered.
+// Where io_uring is unavailable it behaves like BufferedFileStrat.
+//
+// A commit under the outman::SyncPolicy waits for the writes in flight
+// before its fdatasync.
+template <typename TData>
+class UringFileStrat : public BaseFlushableSavingStrategy<TData>, public IGroupCommitStrategy {
+public:
+    static constexpr std::size_t kDefaultBufferSize = std::size_t(1) << 20;
+    static constexpr std::size_t kDefaultBufferCount = 4;
+
+    explicit UringFileStrat(
+        const std::string& file_name,
+        std::size_t buffer_size = kDefaultBufferSize,
+        std::size_t buffer_count = kDefaultBufferCount,
+        const outman::SyncPolicy& sync_policy = outman::SyncPolicy::None()
+    )
+        : file_name_(file_name),
+        writer_(file_name, buffer_size ? buffer_size : kDefaultBufferSize, buffer_count ? buffer_count : 1),
+        committer_(sync_policy, mutex_, [this]() { WriteOutLocked(); }, [this]() { writer_.File().Sync(); }) {}
+
+    ~UringFileStrat() override {
+        committer_.Commit();
+    }
+
+    void AddAsync(const TData& data, outman::SenderId) override {
+        bool commit_now;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::string& buffer = writer_.Current();
+            std::size_t before = buffer.size();
+            outman::RecordAppender<TData>()(buffer, data);
+            commit_now = committer_.Added(buffer.size() - before);
+            if (buffer.size() >= writer_.BufferSize()) {
+                writer_.SubmitCurrent();
+            }
+        }
+        if (commit_now) {
+            committer_.Commit();
+        }
+    }
+
+    void FlushAsync(outman::SenderId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (writer_.HasPendingData()) {
+            writer_.SubmitCurrent();
+        }
+    }
+
+    // Blocks until everything added so far is written to the file.
+    void Drain() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        WriteOutLocked();
+    }
+
+    bool UsesIoUring() const {
+        return writer_.UsesIoUring();
+    }
+
+    const std::string& FileName() const {
+        return file_name_;
+    }
+
+    void WhenCommitted(std::function<void(std::exception_ptr)> done) override {
+        committer_.WhenCommitted(std::move(done));
+    }
+
+    void Commit() override {
+        committer_.Commit();
+    }
+
+    std::chrono::milliseconds CommitCheckInterval() const override {
+        return committer_.CheckInterval();
+    }
+
+    void CommitIfDue(std::chrono::steady_clock::time_point now) override {
+        committer_.CommitIfDue(now);
+    }
+
+private:
+    void WriteOutLocked() {
+        writer_.SubmitCurrent();
+        writer_.Drain();
+    }
+
+    std::string file_name_;
+    outman::detail::UringFileWriter writer_;
+    std::mutex mutex_;
+    outman::detail::GroupCommitter committer_;
+};
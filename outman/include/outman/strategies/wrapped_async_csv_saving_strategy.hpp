@@ -15,7 +15,7 @@ public:
     virtual ~WrappedAsyncCsvSavingStrategy();
 
     // Save the data asynchronously, wrapping the CsvSavingStrategy
-    void SaveAsync(const TData& data, void* sender) override;
+    void SaveAsync(const TData& data, outman::SenderId sender) override;
 
 private:
     // Worker function to process the save queue
@@ -25,7 +25,7 @@ private:
     CsvSavingStrategy<TData> _csvSavingStrategy;
 
     // Save queue and related synchronization primitives
-    std::deque<std::pair<TData, void*>> _saveQueue;
+    std::deque<std::pair<TData, outman::SenderId>> _saveQueue;
     std::mutex _queueMutex;
     std::condition_variable _queueCondition;
 
@@ -41,7 +41,7 @@ private:
 template <typename TData>
 WrappedAsyncCsvSavingStrategy<TData>::WrappedAsyncCsvSavingStrategy(const std::string& outputFilePath)
     : _csvSavingStrategy(outputFilePath), _stopWorkerThread(false) {
-    _workerThread = std::thread(&AsyncCsvSavingStrategy<TData>::ProcessSaveQueue, this);
+    _workerThread = std::thread(&WrappedAsyncCsvSavingStrategy<TData>::ProcessSaveQueue, this);
 }
 
 template <typename TData>
@@ -55,7 +55,7 @@ WrappedAsyncCsvSavingStrategy<TData>::~WrappedAsyncCsvSavingStrategy() {
 }
 
 template <typename TData>
-void WrappedAsyncCsvSavingStrategy<TData>::SaveAsync(const TData& data, void* sender) {
+void WrappedAsyncCsvSavingStrategy<TData>::SaveAsync(const TData& data, outman::SenderId sender) {
     // Add the data to the save queue and notify the worker thread
     std::unique_lock<std::mutex> lock(_queueMutex);
     _saveQueue.emplace_back(data, sender);
@@ -65,27 +65,29 @@ void WrappedAsyncCsvSavingStrategy<TData>::SaveAsync(const TData& data, void* se
 
 template <typename TData>
 void WrappedAsyncCsvSavingStrategy<TData>::ProcessSaveQueue() {
-while (!_stopWorkerThread.load()) {
-std::pair<TData, void*> dataToSave;
-    {
-        std::unique_lock<std::mutex> lock(_queueMutex);
-        
-        // Wait for data in the queue or a stop signal
-        _queueCondition.wait(lock, [this]() {
-            return !_saveQueue.empty() || _stopWorkerThread.load();
-        });
-
-        // Stop the worker thread if requested
-        if (_stopWorkerThread.load()) {
-            break;
+    for (;;) {
+        std::pair<TData, outman::SenderId> dataToSave;
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+
+            // Wait for data in the queue or a stop signal
+            _queueCondition.wait(lock, [this]() {
+                return !_saveQueue.empty() || _stopWorkerThread.load();
+            });
+
+            // Stop only once everything queued before the stop signal is saved
+            if (_saveQueue.empty()) {
+                break;
+            }
+
+            // Get the data from the front of the queue and remove it
+            dataToSave = std::move(_saveQueue.front());
+            _saveQueue.pop_front();
         }
 
-        // Get the data from the front of the queue and remove it
-        dataToSave = _saveQueue.front();
-        _saveQueue.pop_front();
+        // Save the data using the wrapped CsvSavingStrategy
+        _csvSavingStrategy.Save(dataToSave.first, dataToSave.second);
     }
-
-    // Save the data using the wrapped CsvSavingStrategy
-    _csvSavingStrategy.Save(dataToSave.first, dataToSave.second);
+}
 
 #endif  // OUTMAN_ASYNC_CSV_SAVING_STRATEGY_HPP
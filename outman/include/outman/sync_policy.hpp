@@ -0,0 +1,48 @@
+#ifndef OUTMAN_SYNC_POLICY_HPP
+#define OUTMAN_SYNC_POLICY_HPP
+
+#include <chrono>
+#include <cstddef>
+
+namespace outman {
+    enum class SyncMode {
+        // Never sync; the kernel writes data back when it wants to.
+        None,
+        // Sync whatever arrived, at most once per interval.
+        Interval,
+        // Sync once this many bytes arrived since the last sync.
+        Bytes,
+        // Sync after every batch the manager drains into the sink.
+        EveryBatch
+    };
+
+    // When a file sink makes its data durable with fdatasync. Records that
+    // arrive between two syncs share one ("group commit"), and completions
+    // of those records (SaveAsync with a completion token, SaveAsyncTracked)
+    // are released together once the sync that covers them returned.
+    struct SyncPolicy {
+        SyncMode mode = SyncMode::None;
+        // Interval: the sync period. Bytes: the longest a record waits for
+        // its sync when too few bytes follow it; zero waits for the bytes.
+        std::chrono::milliseconds interval{ 0 };
+        std::size_t bytes = 0;
+
+        static SyncPolicy None() {
+            return {};
+        }
+
+        static SyncPolicy Interval(std::chrono::milliseconds interval) {
+            return { SyncMode::Interval, interval, 0 };
+        }
+
+        static SyncPolicy EveryBytes(std::size_t bytes, std::chrono::milliseconds max_wait = std::chrono::milliseconds(1000)) {
+            return { SyncMode::Bytes, max_wait, bytes };
+        }
+
+        static SyncPolicy EveryBatch() {
+            return { SyncMode::EveryBatch, std::chrono::milliseconds(0), 0 };
+        }
+    };
+}
+
+#endif  // OUTMAN_SYNC_POLICY_HPP
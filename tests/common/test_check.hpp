@@ -0,0 +1,44 @@
+#ifndef OUTMAN_TESTS_TEST_CHECK_HPP
+#define OUTMAN_TESTS_TEST_CHECK_HPP
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+// Minimal checks shared by the test apps: a failed CHECK prints where and
+// what, and the app exits with the number of failures.
+namespace test_check {
+    inline int& Failures() {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline void Check(bool ok, const char* expression, const char* file, int line) {
+        if (!ok) {
+            ++Failures();
+            std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+        }
+    }
+
+    // Polls `done` until it holds or `timeout` passed; returns its last value.
+    inline bool WaitFor(const std::function<bool()>& done, std::chrono::milliseconds timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!done()) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return done();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    inline int Result(const char* name) {
+        std::cout << name << ": " << (Failures() == 0 ? "passed" : "FAILED") << std::endl;
+        return Failures();
+    }
+}
+
+#define CHECK(expression) ::test_check::Check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+#endif  // OUTMAN_TESTS_TEST_CHECK_HPP
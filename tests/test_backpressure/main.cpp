@@ -0,0 +1,162 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <outman/outman.hpp>
+#include "outman/all_strats.hpp"
+
+#include "test_check.hpp"
+
+using std::chrono::milliseconds;
+
+// Holds its first record until released, so the queue behind it fills up
+// exactly as the test says.
+class GatedStrat : public ISavingStrategy<int> {
+public:
+    GatedStrat() : release_future_(release_.get_future().share()) {}
+
+    void Save(const int& data, outman::SenderId /*sender*/) override {
+        if (!entered_.exchange(true)) {
+            release_future_.wait();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        saved_.push_back(data);
+    }
+
+    bool Entered() const {
+        return entered_;
+    }
+
+    void Release() {
+        release_.set_value();
+    }
+
+    std::vector<int> Saved() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return saved_;
+    }
+
+private:
+    std::promise<void> release_;
+    std::shared_future<void> release_future_;
+    std::atomic<bool> entered_{ false };
+    std::mutex mutex_;
+    std::vector<int> saved_;
+};
+
+struct Outcome {
+    outman::BackpressureStats stats;
+    std::size_t try_rejected = 0;
+    std::vector<int> saved;
+};
+
+// Record 0 occupies the strategy; records 1..10 then meet a queue of four.
+Outcome Overflow(outman::BackpressurePolicy policy) {
+    outman::OutputManager manager;
+    auto strategy = std::make_shared<GatedStrat>();
+    outman::QueueLimits limits;
+    limits.capacity = 4;
+    limits.policy = policy;
+    limits.keep_every = 3;
+    manager.AddStrategy<int>(strategy, limits);
+
+    manager.SaveAsync(0, outman::SenderId());
+    CHECK(test_check::WaitFor([&strategy]() { return strategy->Entered(); }, milliseconds(5000)));
+
+    Outcome outcome;
+    for (int i = 1; i <= 10; ++i) {
+        outcome.try_rejected += manager.TrySaveAsync(i, outman::SenderId()).rejected;
+    }
+    outcome.stats = manager.GetBackpressureStats<int>()[0];
+    strategy->Release();
+    manager.Shutdown(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    outcome.saved = strategy->Saved();
+    return outcome;
+}
+
+void FailFast() {
+    auto outcome = Overflow(outman::BackpressurePolicy::FailFast);
+    CHECK(outcome.stats.accepted == 5);
+    CHECK(outcome.stats.rejected == 6);
+    CHECK(outcome.stats.queued == 4);
+    CHECK(outcome.try_rejected == 6);
+    CHECK((outcome.saved == std::vector<int>{ 0, 1, 2, 3, 4 }));
+}
+
+void BlockUnderTrySave() {
+    auto outcome = Overflow(outman::BackpressurePolicy::Block);
+    CHECK(outcome.stats.rejected == 6);
+    CHECK(outcome.stats.blocked == 0);
+    CHECK(outcome.try_rejected == 6);
+    CHECK((outcome.saved == std::vector<int>{ 0, 1, 2, 3, 4 }));
+}
+
+void DropNewest() {
+    auto outcome = Overflow(outman::BackpressurePolicy::DropNewest);
+    CHECK(outcome.stats.accepted == 5);
+    CHECK(outcome.stats.dropped_newest == 6);
+    CHECK(outcome.stats.rejected == 0);
+    CHECK((outcome.saved == std::vector<int>{ 0, 1, 2, 3, 4 }));
+}
+
+void DropOldest() {
+    auto outcome = Overflow(outman::BackpressurePolicy::DropOldest);
+    CHECK(outcome.stats.accepted == 11);
+    CHECK(outcome.stats.dropped_oldest == 6);
+    CHECK(outcome.try_rejected == 0);
+    CHECK((outcome.saved == std::vector<int>{ 0, 7, 8, 9, 10 }));
+}
+
+// Of the six records that find the queue full, every third replaces the
+// oldest queued one.
+void KeepEveryNth() {
+    auto outcome = Overflow(outman::BackpressurePolicy::KeepEveryNth);
+    CHECK(outcome.stats.sampled_out == 4);
+    CHECK(outcome.stats.dropped_oldest == 2);
+    CHECK((outcome.saved == std::vector<int>{ 0, 3, 4, 7, 10 }));
+}
+
+// A producer using SaveAsync waits for room and loses nothing.
+void BlockWaitsForRoom() {
+    outman::OutputManager manager;
+    auto strategy = std::make_shared<GatedStrat>();
+    outman::QueueLimits limits;
+    limits.capacity = 4;
+    limits.policy = outman::BackpressurePolicy::Block;
+    manager.AddStrategy<int>(strategy, limits);
+
+    manager.SaveAsync(0, outman::SenderId());
+    CHECK(test_check::WaitFor([&strategy]() { return strategy->Entered(); }, milliseconds(5000)));
+
+    std::thread producer([&manager]() {
+        for (int i = 1; i <= 10; ++i) {
+            manager.SaveAsync(i, outman::SenderId());
+        }
+    });
+    CHECK(test_check::WaitFor([&manager]() {
+        return manager.GetBackpressureStats<int>()[0].blocked == 1;
+    }, milliseconds(5000)));
+    strategy->Release();
+    producer.join();
+    manager.Shutdown(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+
+    auto stats = manager.GetBackpressureStats<int>()[0];
+    CHECK(stats.accepted == 11);
+    CHECK(stats.rejected == 0);
+    CHECK(stats.blocked >= 1);
+    CHECK((strategy->Saved() == std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }));
+}
+
+int main() {
+    FailFast();
+    BlockUnderTrySave();
+    DropNewest();
+    DropOldest();
+    KeepEveryNth();
+    BlockWaitsForRoom();
+    return test_check::Result("backpressure");
+}
@@ -0,0 +1,186 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <outman/outman.hpp>
+#include "outman/all_strats.hpp"
+#include "outman/columnar_reader.hpp"
+
+#include "test_check.hpp"
+
+enum class Side : std::uint8_t { Buy, Sell };
+
+struct Tick {
+    std::int64_t time;
+    std::string symbol;
+    double price;
+    std::int32_t qty;
+    Side side;
+    bool flag;
+    float ratio;
+};
+OUTMAN_RECORD_FIELDS(Tick, time, symbol, price, qty, side, flag, ratio)
+
+Tick MakeTick(int k) {
+    static const char* symbols[] = { "AAPL", "MSFT", "GOOG", "AMZN" };
+    return Tick{
+        1700000000000LL + k * 3,
+        symbols[(k / 7) % 4],
+        100.0 + (k % 1000) * 0.01,
+        k % 100 - 50,
+        k % 2 ? Side::Buy : Side::Sell,
+        // Constant within a row group, so Rle stores it in one run.
+        (k / 1000) % 2 == 0,
+        k % 13 == 0 ? -0.0f : static_cast<float>(k) / 7
+    };
+}
+
+// Seven column types, forced and automatic encodings, and a last row group
+// holding only what the shutdown flush found.
+void RoundTrip() {
+    constexpr int rows = 2500;
+    constexpr std::size_t group_size = 1000;
+    const std::string file_name = "columnar_roundtrip.col";
+    {
+        outman::OutputManager manager;
+        auto strategy = std::make_shared<ColumnarFileStrat<Tick>>(file_name, group_size, std::map<std::string, outman::ColumnEncoding>{
+            { "time", outman::ColumnEncoding::Delta },
+            { "symbol", outman::ColumnEncoding::Dictionary },
+            { "price", outman::ColumnEncoding::Plain },
+            { "flag", outman::ColumnEncoding::Rle },
+        });
+        outman::FlushPolicy policy;
+        policy.max_records = group_size;
+        manager.AddFlushableStrategy<Tick>(strategy, policy);
+        for (int k = 0; k < rows; ++k) {
+            manager.SaveAsync(MakeTick(k), outman::SenderId());
+        }
+        manager.Shutdown(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    }
+
+    outman::ColumnarFileReader reader(file_name);
+    CHECK(reader.ColumnCount() == 7);
+    CHECK(reader.RowCount() == rows);
+    CHECK(reader.RowGroupCount() == 3);
+    if (reader.RowGroupCount() == 3) {
+        CHECK(reader.RowCount(0) == group_size);
+        CHECK(reader.RowCount(1) == group_size);
+        CHECK(reader.RowCount(2) == rows - 2 * group_size);
+        CHECK(reader.Encoding(0, 0) == outman::ColumnEncoding::Delta);
+        CHECK(reader.Encoding(2, 5) == outman::ColumnEncoding::Rle);
+    }
+    CHECK(reader.GetColumnType(4) == outman::ColumnType::UInt8);
+    CHECK(reader.GetColumnType(6) == outman::ColumnType::Float32);
+
+    auto time = reader.ReadColumn<std::int64_t>("time");
+    auto symbol = reader.ReadColumn<std::string>("symbol");
+    auto price = reader.ReadColumn<double>("price");
+    auto qty = reader.ReadColumn<std::int32_t>("qty");
+    auto side = reader.ReadColumn<Side>("side");
+    auto flag = reader.ReadColumn<bool>("flag");
+    auto ratio = reader.ReadColumn<float>("ratio");
+    CHECK(time.size() == rows && symbol.size() == rows && price.size() == rows && qty.size() == rows
+        && side.size() == rows && flag.size() == rows && ratio.size() == rows);
+
+    int mismatches = 0;
+    for (int k = 0; k < rows && k < static_cast<int>(ratio.size()); ++k) {
+        Tick tick = MakeTick(k);
+        bool same = tick.time == time[k] && tick.symbol == symbol[k] && tick.price == price[k]
+            && tick.qty == qty[k] && tick.side == side[k] && tick.flag == flag[k]
+            && tick.ratio == ratio[k] && std::signbit(tick.ratio) == std::signbit(ratio[k]);
+        mismatches += same ? 0 : 1;
+    }
+    CHECK(mismatches == 0);
+
+    auto stats = reader.Stats<std::int64_t>(1, 0);
+    CHECK(stats && stats->first == MakeTick(1000).time && stats->second == MakeTick(1999).time);
+
+    bool type_checked = false;
+    try {
+        reader.ReadColumn<std::int32_t>("time");
+    }
+    catch (const std::invalid_argument&) {
+        type_checked = true;
+    }
+    CHECK(type_checked);
+    std::remove(file_name.c_str());
+}
+
+// A file with one Plain int64 chunk of two values, under a footer that
+// claims `rows` rows at `offset`.
+void WriteForgedFile(const std::string& file_name, std::uint64_t rows, std::uint64_t offset) {
+    std::string data(outman::kColumnarMagic, sizeof(outman::kColumnarMagic));
+    outman::detail::PutFixed(data, 1, 8);
+    outman::detail::PutFixed(data, 2, 8);
+
+    outman::detail::ColumnarFileMeta meta;
+    meta.columns.push_back({ "x", outman::ColumnType::Int64 });
+    outman::detail::RowGroupMeta group;
+    group.rows = rows;
+    outman::detail::ColumnChunkMeta chunk;
+    chunk.offset = offset;
+    chunk.size = 16;
+    chunk.encoding = outman::ColumnEncoding::Plain;
+    group.chunks.push_back(chunk);
+    meta.row_groups.push_back(group);
+    outman::detail::PutFooter(meta, data);
+
+    std::ofstream(file_name, std::ios::binary) << data;
+}
+
+template <typename TFn>
+bool ThrowsRuntimeError(TFn&& fn) {
+    try {
+        fn();
+    }
+    catch (const std::runtime_error&) {
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+    return false;
+}
+
+// Row counts and chunk bounds come from the footer; forged ones are
+// reported as a corrupt file before anything is allocated for them.
+void CorruptFooter() {
+    const std::string file_name = "columnar_corrupt.col";
+    constexpr std::uint64_t chunk_offset = sizeof(outman::kColumnarMagic);
+
+    WriteForgedFile(file_name, 2, chunk_offset);
+    {
+        outman::ColumnarFileReader reader(file_name);
+        auto values = reader.ReadColumn<std::int64_t>("x");
+        CHECK(values.size() == 2 && values[0] == 1 && values[1] == 2);
+    }
+
+    WriteForgedFile(file_name, std::uint64_t(1) << 60, chunk_offset);
+    CHECK(ThrowsRuntimeError([&file_name]() {
+        outman::ColumnarFileReader(file_name).ReadColumn<std::int64_t>("x");
+    }));
+
+    WriteForgedFile(file_name, 3, chunk_offset);
+    CHECK(ThrowsRuntimeError([&file_name]() {
+        outman::ColumnarFileReader(file_name).ReadColumn<std::int64_t>("x");
+    }));
+
+    WriteForgedFile(file_name, 2, std::uint64_t(1) << 40);
+    CHECK(ThrowsRuntimeError([&file_name]() {
+        outman::ColumnarFileReader reader(file_name);
+    }));
+    std::remove(file_name.c_str());
+}
+
+int main() {
+    RoundTrip();
+    CorruptFooter();
+    return test_check::Result("columnar_roundtrip");
+}
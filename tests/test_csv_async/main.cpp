@@ -47,13 +47,13 @@ int main() {
         manager.AddStrategy(csv_strategy);
     }
 
+    const auto sender = outman::SenderId::Register("test_main_" +
+        std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+
     std::vector<std::string> csv_data;
     for (int i = 0; i < 3; ++i) {
         csv_data.push_back(generate_csv_data(50000, 30));
-		logger->Log("Generated csv data " + std::to_string(i),
-             new std::string("test_main_" +
-                 std::to_string(std::hash<std::thread::id>{}(
-                     std::this_thread::get_id()))));
+		logger->Log("Generated csv data " + std::to_string(i), sender);
     }
 
     auto start_time = std::chrono::high_resolution_clock::now();
@@ -61,23 +61,20 @@ int main() {
     // Save the big CSV files asynchronously using OutputManager
 	for (const auto& data : csv_data) {
 		//save_futures.emplace_back(std::async(std::launch::async, [&manager, &data] {
-		manager.SaveAsync(data, new std::string("test_main_" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()))));
+		manager.SaveAsync(data, sender);
 		auto timenow_ = std::chrono::high_resolution_clock::now();
-		logger->Log("SaveAsync called", static_cast<const void*>(&manager));
+		logger->Log("SaveAsync called", outman::SenderId::Manager());
 	}
 
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
 
     logger->Log("Asynchronously called to save big CSV files in " +
-        std::to_string(duration) + " us", static_cast<const void*>(&manager));
+        std::to_string(duration) + " us", outman::SenderId::Manager());
 
     for (int i = 0; i < 5; ++i) {
         csv_data.push_back(generate_csv_data(10000, 20));
-		logger->Log("Generated csv data " + std::to_string(i),
-             new std::string("test_main_" +
-                 std::to_string(std::hash<std::thread::id>{}(
-                     std::this_thread::get_id()))));
+		logger->Log("Generated csv data " + std::to_string(i), sender);
     }
 
     return 0;
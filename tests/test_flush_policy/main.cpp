@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <outman/outman.hpp>
+#include "outman/all_strats.hpp"
+
+#include "test_check.hpp"
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+// A record that knows when it was saved.
+struct Stamped {
+    Clock::time_point saved;
+};
+
+// Counts the records of each flush and how stale the oldest one was.
+template <typename TData>
+class FlushRecorder : public IFlushableSavingStrategy<TData> {
+public:
+    void Save(const TData& data, outman::SenderId sender) override {
+        AddAsync(data, sender);
+    }
+
+    void AddAsync(const TData& data, outman::SenderId /*sender*/) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_ == 0) {
+            oldest_ = SavedAt(data);
+        }
+        ++pending_;
+        ++added_;
+    }
+
+    void FlushAsync(outman::SenderId /*sender*/) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_ == 0) {
+            return;
+        }
+        sizes_.push_back(pending_);
+        staleness_.push_back(Clock::now() - oldest_);
+        pending_ = 0;
+    }
+
+    std::size_t Added() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return added_;
+    }
+
+    std::vector<std::size_t> Sizes() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sizes_;
+    }
+
+    std::vector<Clock::duration> Staleness() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return staleness_;
+    }
+
+private:
+    static Clock::time_point SavedAt(const Stamped& data) {
+        return data.saved;
+    }
+
+    template <typename T>
+    static Clock::time_point SavedAt(const T&) {
+        return Clock::now();
+    }
+
+    std::mutex mutex_;
+    std::size_t pending_ = 0;
+    std::size_t added_ = 0;
+    Clock::time_point oldest_;
+    std::vector<std::size_t> sizes_;
+    std::vector<Clock::duration> staleness_;
+};
+
+// Every flush but the last one at shutdown holds exactly `size` records.
+void CheckFlushSizes(const std::vector<std::size_t>& sizes, std::size_t total, std::size_t size) {
+    CHECK(sizes.size() == (total + size - 1) / size);
+    for (std::size_t i = 0; i + 1 < sizes.size(); ++i) {
+        CHECK(sizes[i] == size);
+    }
+}
+
+void RecordCountTrigger() {
+    outman::OutputManager manager;
+    auto strategy = std::make_shared<FlushRecorder<int>>();
+    outman::FlushPolicy policy;
+    policy.max_records = 10;
+    manager.AddFlushableStrategy<int>(strategy, policy);
+
+    for (int i = 0; i < 1005; ++i) {
+        manager.SaveAsync(i, outman::SenderId());
+    }
+    manager.Shutdown(Clock::now() + std::chrono::seconds(10));
+    CHECK(strategy->Added() == 1005);
+    CheckFlushSizes(strategy->Sizes(), 1005, 10);
+}
+
+void ByteTrigger() {
+    outman::OutputManager manager;
+    auto strategy = std::make_shared<FlushRecorder<std::string>>();
+    outman::FlushPolicy policy;
+    // RecordSize counts a string's characters: 100 bytes per record.
+    policy.max_bytes = 1000;
+    manager.AddFlushableStrategy<std::string>(strategy, policy);
+
+    for (int i = 0; i < 500; ++i) {
+        manager.SaveAsync(std::string(100, 'x'), outman::SenderId());
+    }
+    manager.Shutdown(Clock::now() + std::chrono::seconds(10));
+    CHECK(strategy->Added() == 500);
+    CheckFlushSizes(strategy->Sizes(), 500, 10);
+}
+
+// A lone record is flushed once it is max_age old, by the flush timer.
+void AgeTrigger() {
+    outman::OutputManagerConfig config;
+    config.flush_tick = milliseconds(1);
+    outman::OutputManager manager(config);
+    auto strategy = std::make_shared<FlushRecorder<Stamped>>();
+    outman::FlushPolicy policy;
+    policy.max_age = milliseconds(30);
+    manager.AddFlushableStrategy<Stamped>(strategy, policy);
+
+    manager.SaveAsync(Stamped{ Clock::now() }, outman::SenderId());
+    CHECK(test_check::WaitFor([&strategy]() { return strategy->Added() == 1; }, milliseconds(1000)));
+    CHECK(strategy->Sizes().empty());
+
+    CHECK(test_check::WaitFor([&strategy]() { return !strategy->Sizes().empty(); }, milliseconds(2000)));
+    auto staleness = strategy->Staleness();
+    CHECK(!staleness.empty() && staleness[0] >= milliseconds(30));
+}
+
+// Time a record spends queued behind a busy worker counts towards its age:
+// records older than max_age when drained are flushed by that drain.
+void AgeCountsQueueWait() {
+    outman::OutputManagerConfig config;
+    config.worker_count = 1;
+    outman::OutputManager manager(config);
+    auto strategy = std::make_shared<FlushRecorder<Stamped>>();
+    outman::FlushPolicy policy;
+    policy.max_age = milliseconds(50);
+    manager.AddFlushableStrategy<Stamped>(strategy, policy);
+
+    // Occupy the only worker so the records wait in the queue.
+    boost::asio::post(manager.GetExecutor(), []() {
+        std::this_thread::sleep_for(milliseconds(100));
+    });
+    for (int i = 0; i < 5; ++i) {
+        manager.SaveAsync(Stamped{ Clock::now() }, outman::SenderId());
+    }
+
+    CHECK(test_check::WaitFor([&strategy]() { return strategy->Added() == 5; }, milliseconds(2000)));
+    auto sizes = strategy->Sizes();
+    CHECK(!sizes.empty() && sizes[0] == 1);
+    manager.Shutdown(Clock::now() + std::chrono::seconds(10));
+}
+
+// Under a steady stream the adaptive policy batches records while keeping
+// the 99th percentile staleness near its target.
+void AdaptiveTarget() {
+    outman::OutputManagerConfig config;
+    config.flush_tick = milliseconds(1);
+    outman::OutputManager manager(config);
+    auto strategy = std::make_shared<FlushRecorder<Stamped>>();
+    outman::FlushPolicy policy;
+    policy.staleness_target = milliseconds(20);
+    manager.AddFlushableStrategy<Stamped>(strategy, policy);
+
+    auto end = Clock::now() + milliseconds(1000);
+    std::size_t saved = 0;
+    while (Clock::now() < end) {
+        manager.SaveAsync(Stamped{ Clock::now() }, outman::SenderId());
+        ++saved;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    manager.Shutdown(Clock::now() + std::chrono::seconds(10));
+    CHECK(strategy->Added() == saved);
+
+    auto sizes = strategy->Sizes();
+    auto staleness = strategy->Staleness();
+    CHECK(sizes.size() >= 10);
+    CHECK(sizes.size() < saved / 2);
+    if (staleness.size() >= 10) {
+        std::sort(staleness.begin(), staleness.end());
+        auto p99 = staleness[(staleness.size() * 99 + 99) / 100 - 1];
+        CHECK(p99 <= milliseconds(60));
+    }
+}
+
+int main() {
+    RecordCountTrigger();
+    ByteTrigger();
+    AgeTrigger();
+    AgeCountsQueueWait();
+    AdaptiveTarget();
+    return test_check::Result("flush_policy");
+}
@@ -0,0 +1,221 @@
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <outman/outman.hpp>
+#include "outman/all_strats.hpp"
+
+#include "test_check.hpp"
+
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+// A sink that counts its syncs instead of touching a file. Every record
+// takes one byte; the first AddAsync waits for `gate` when one is given.
+class CountingSyncStrat : public BaseFlushableSavingStrategy<int>, public IGroupCommitStrategy {
+public:
+    explicit CountingSyncStrat(const outman::SyncPolicy& policy, std::shared_future<void> gate = {})
+        : gate_(std::move(gate)),
+        committer_(policy, mutex_, [this]() { writing_ = added_; }, [this]() { ++syncs_; synced_ = writing_; }) {}
+
+    void AddAsync(const int& /*data*/, outman::SenderId /*sender*/) override {
+        if (!entered_.exchange(true) && gate_.valid()) {
+            gate_.wait();
+        }
+        bool commit_now;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++added_;
+            commit_now = committer_.Added(1);
+        }
+        if (commit_now) {
+            committer_.Commit();
+        }
+    }
+
+    void FlushAsync(outman::SenderId /*sender*/) override {}
+
+    void WhenCommitted(std::function<void(std::exception_ptr)> done) override {
+        committer_.WhenCommitted(std::move(done));
+    }
+
+    void Commit() override {
+        committer_.Commit();
+    }
+
+    std::chrono::milliseconds CommitCheckInterval() const override {
+        return committer_.CheckInterval();
+    }
+
+    void CommitIfDue(steady_clock::time_point now) override {
+        committer_.CommitIfDue(now);
+    }
+
+    bool Entered() const {
+        return entered_;
+    }
+
+    int Added() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return added_;
+    }
+
+    int Syncs() const {
+        return syncs_;
+    }
+
+    // Records covered by the last sync.
+    int Synced() const {
+        return synced_;
+    }
+
+private:
+    std::shared_future<void> gate_;
+    std::atomic<bool> entered_{ false };
+    std::mutex mutex_;
+    int added_ = 0;
+    int writing_ = 0;
+    std::atomic<int> syncs_{ 0 };
+    std::atomic<int> synced_{ 0 };
+    outman::detail::GroupCommitter committer_;
+};
+
+// Saves `count` records with completions and counts those that completed
+// with an error, or before a sync covered them. Completions run on the
+// manager's workers, so they only count.
+class Submitter {
+public:
+    Submitter(outman::OutputManager& manager, CountingSyncStrat& strategy) : manager_(manager), strategy_(strategy) {}
+
+    void Save(int count) {
+        for (int i = 0; i < count; ++i, ++next_) {
+            int needed = next_ + 1;
+            manager_.SaveAsync(next_, outman::SenderId(), [this, needed](std::exception_ptr error) {
+                if (error) {
+                    ++failed_;
+                }
+                if (strategy_.Synced() < needed) {
+                    ++early_;
+                }
+                ++completed_;
+            });
+        }
+    }
+
+    bool WaitAll(milliseconds timeout) {
+        return test_check::WaitFor([this]() { return completed_ == next_; }, timeout);
+    }
+
+    int Early() const {
+        return early_;
+    }
+
+    int Failed() const {
+        return failed_;
+    }
+
+private:
+    outman::OutputManager& manager_;
+    CountingSyncStrat& strategy_;
+    int next_ = 0;
+    std::atomic<int> completed_{ 0 };
+    std::atomic<int> early_{ 0 };
+    std::atomic<int> failed_{ 0 };
+};
+
+// No sync policy: records complete as soon as the sink took them.
+void NoneNeverSyncs() {
+    outman::OutputManager manager;
+    auto strategy = std::make_shared<CountingSyncStrat>(outman::SyncPolicy::None());
+    manager.AddStrategy<int>(strategy);
+    Submitter submitter(manager, *strategy);
+
+    submitter.Save(500);
+    CHECK(submitter.WaitAll(milliseconds(5000)));
+    CHECK(submitter.Failed() == 0);
+    manager.Shutdown(steady_clock::now() + std::chrono::seconds(5));
+    CHECK(strategy->Syncs() == 0);
+}
+
+// Records that queued up behind a stalled sink share one sync per drained
+// batch instead of one each.
+void EveryBatchGroupsRecords() {
+    constexpr int records = 200;
+
+    std::promise<void> release;
+    outman::OutputManager manager;
+    auto strategy = std::make_shared<CountingSyncStrat>(outman::SyncPolicy::EveryBatch(), release.get_future().share());
+    manager.AddStrategy<int>(strategy);
+    Submitter submitter(manager, *strategy);
+
+    submitter.Save(1);
+    CHECK(test_check::WaitFor([&strategy]() { return strategy->Entered(); }, milliseconds(5000)));
+    submitter.Save(records - 1);
+    release.set_value();
+
+    CHECK(submitter.WaitAll(milliseconds(5000)));
+    CHECK(submitter.Early() == 0);
+    CHECK(submitter.Failed() == 0);
+    // The first record, then the rest in drain batches of 64.
+    CHECK(strategy->Syncs() >= 2);
+    CHECK(strategy->Syncs() <= 1 + (records - 1 + 63) / 64);
+    manager.Shutdown(steady_clock::now() + std::chrono::seconds(5));
+}
+
+// One sync per `bytes` bytes, and Shutdown commits the remainder.
+void BytesSyncsPerThreshold() {
+    constexpr int records = 100;
+
+    outman::OutputManager manager;
+    auto strategy = std::make_shared<CountingSyncStrat>(outman::SyncPolicy::EveryBytes(10, milliseconds(0)));
+    manager.AddStrategy<int>(strategy);
+    Submitter submitter(manager, *strategy);
+
+    submitter.Save(records);
+    CHECK(test_check::WaitFor([&strategy]() { return strategy->Added() == records; }, milliseconds(5000)));
+    CHECK(strategy->Syncs() == records / 10);
+
+    manager.Shutdown(steady_clock::now() + std::chrono::seconds(5));
+    CHECK(submitter.WaitAll(milliseconds(5000)));
+    CHECK(submitter.Early() == 0);
+    CHECK(submitter.Failed() == 0);
+    CHECK(strategy->Syncs() <= records / 10 + 1);
+}
+
+// The flush timer syncs about once per interval however many records
+// arrive in between.
+void IntervalSyncsPeriodically() {
+    constexpr int rounds = 40;
+    constexpr int per_round = 50;
+
+    outman::OutputManager manager;
+    auto strategy = std::make_shared<CountingSyncStrat>(outman::SyncPolicy::Interval(milliseconds(20)));
+    manager.AddStrategy<int>(strategy);
+    Submitter submitter(manager, *strategy);
+
+    auto start = steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        submitter.Save(per_round);
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+    CHECK(submitter.WaitAll(milliseconds(5000)));
+    auto elapsed = steady_clock::now() - start;
+    CHECK(submitter.Early() == 0);
+    CHECK(submitter.Failed() == 0);
+    CHECK(strategy->Syncs() >= 2);
+    CHECK(strategy->Syncs() <= elapsed / milliseconds(20) + 2);
+    manager.Shutdown(steady_clock::now() + std::chrono::seconds(5));
+}
+
+int main() {
+    NoneNeverSyncs();
+    EveryBatchGroupsRecords();
+    BytesSyncsPerThreshold();
+    IntervalSyncsPeriodically();
+    return test_check::Result("group_commit");
+}
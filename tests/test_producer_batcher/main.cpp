@@ -0,0 +1,146 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <outman/outman.hpp>
+#include "outman/all_strats.hpp"
+
+#include "test_check.hpp"
+
+// Records what it saved, slowly enough for a small queue to fill up.
+class RecordingStrat : public ISavingStrategy<int> {
+public:
+    explicit RecordingStrat(std::chrono::microseconds delay) : delay_(delay) {}
+
+    void Save(const int& data, outman::SenderId /*sender*/) override {
+        std::this_thread::sleep_for(delay_);
+        std::lock_guard<std::mutex> lock(mutex_);
+        saved_.push_back(data);
+    }
+
+    std::vector<int> Saved() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return saved_;
+    }
+
+private:
+    std::chrono::microseconds delay_;
+    std::mutex mutex_;
+    std::vector<int> saved_;
+};
+
+constexpr int kStride = 1000000;
+
+// Every record of every producer arrived, in the order its producer saved it.
+void CheckComplete(const std::vector<int>& saved, int producers, int records) {
+    CHECK(saved.size() == static_cast<std::size_t>(producers * records));
+    std::vector<int> next(producers, 0);
+    for (int value : saved) {
+        int producer = value / kStride;
+        CHECK(producer >= 0 && producer < producers);
+        if (producer < 0 || producer >= producers) {
+            continue;
+        }
+        CHECK(value % kStride == next[producer]);
+        next[producer] = value % kStride + 1;
+    }
+}
+
+// Producers hand full batches into a Block queue far smaller than a batch.
+void FullBatchesWaitForRoom(std::size_t workers) {
+    constexpr int producers = 3;
+    constexpr int records = 2000;
+
+    outman::OutputManagerConfig config;
+    config.worker_count = workers;
+    outman::OutputManager manager(config);
+
+    outman::ChannelOptions options;
+    options.batch_size = 32;
+    manager.ConfigureChannel<int>(options);
+
+    auto bounded = std::make_shared<RecordingStrat>(std::chrono::microseconds(20));
+    auto unbounded = std::make_shared<RecordingStrat>(std::chrono::microseconds(0));
+    outman::QueueLimits limits;
+    limits.capacity = 8;
+    limits.policy = outman::BackpressurePolicy::Block;
+    manager.AddStrategy<int>(bounded, limits);
+    manager.AddStrategy<int>(unbounded);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&manager, p]() {
+            for (int i = 0; i < records; ++i) {
+                manager.SaveAsync(p * kStride + i, outman::SenderId());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto report = manager.Shutdown(std::chrono::steady_clock::now() + std::chrono::seconds(30));
+    CHECK(report.drained);
+
+    auto stats = manager.GetBackpressureStats<int>();
+    CHECK(stats.size() == 2);
+    CHECK(stats[0].rejected == 0);
+    CHECK(stats[0].blocked > 0);
+    CHECK(stats[0].accepted == producers * records);
+
+    CheckComplete(bounded->Saved(), producers, records);
+    CheckComplete(unbounded->Saved(), producers, records);
+}
+
+// A buffer that never reaches batch_size is handed off by the timer sweep,
+// piece by piece as the full Block queue makes room.
+void SweepHandsOffWhatFits() {
+    constexpr int records = 100;
+
+    outman::OutputManagerConfig config;
+    config.worker_count = 1;
+    outman::OutputManager manager(config);
+
+    outman::ChannelOptions options;
+    options.batch_size = 1000;
+    options.batch_age = std::chrono::milliseconds(2);
+    manager.ConfigureChannel<int>(options);
+
+    auto strategy = std::make_shared<RecordingStrat>(std::chrono::microseconds(200));
+    outman::QueueLimits limits;
+    limits.capacity = 4;
+    limits.policy = outman::BackpressurePolicy::Block;
+    manager.AddStrategy<int>(strategy, limits);
+
+    // The producer stays alive, so only the sweep can hand its buffer off.
+    std::promise<void> release;
+    std::thread producer([&manager, done = release.get_future()]() mutable {
+        for (int i = 0; i < records; ++i) {
+            manager.SaveAsync(i, outman::SenderId());
+        }
+        done.wait();
+    });
+
+    bool arrived = test_check::WaitFor([&strategy]() {
+        return strategy->Saved().size() == records;
+    }, std::chrono::seconds(10));
+    CHECK(arrived);
+
+    release.set_value();
+    producer.join();
+    manager.Shutdown(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+
+    CHECK(manager.GetBackpressureStats<int>()[0].rejected == 0);
+    CheckComplete(strategy->Saved(), 1, records);
+}
+
+int main() {
+    FullBatchesWaitForRoom(1);
+    FullBatchesWaitForRoom(3);
+    SweepHandsOffWhatFits();
+    return test_check::Result("producer_batcher");
+}
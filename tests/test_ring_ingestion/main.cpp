@@ -0,0 +1,177 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <outman/outman.hpp>
+#include "outman/all_strats.hpp"
+
+#include "test_check.hpp"
+
+using std::chrono::milliseconds;
+
+// Records what it saved; the first Save waits for `gate` when one is given.
+class RecordingStrat : public ISavingStrategy<int> {
+public:
+    explicit RecordingStrat(std::chrono::microseconds delay = std::chrono::microseconds(0), std::shared_future<void> gate = {})
+        : delay_(delay), gate_(std::move(gate)) {}
+
+    void Save(const int& data, outman::SenderId /*sender*/) override {
+        if (!entered_.exchange(true) && gate_.valid()) {
+            gate_.wait();
+        }
+        if (delay_.count() > 0) {
+            std::this_thread::sleep_for(delay_);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        saved_.push_back(data);
+    }
+
+    bool Entered() const {
+        return entered_;
+    }
+
+    std::vector<int> Saved() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return saved_;
+    }
+
+private:
+    std::chrono::microseconds delay_;
+    std::shared_future<void> gate_;
+    std::atomic<bool> entered_{ false };
+    std::mutex mutex_;
+    std::vector<int> saved_;
+};
+
+constexpr int kStride = 1000000;
+
+// Every record of every producer arrived once, in its producer's order.
+void CheckComplete(const std::vector<int>& saved, int producers, int records) {
+    CHECK(saved.size() == static_cast<std::size_t>(producers * records));
+    std::vector<int> next(producers, 0);
+    for (int value : saved) {
+        int producer = value / kStride;
+        if (producer < 0 || producer >= producers) {
+            CHECK(producer >= 0 && producer < producers);
+            continue;
+        }
+        CHECK(value % kStride == next[producer]);
+        next[producer] = value % kStride + 1;
+    }
+}
+
+outman::ChannelOptions RingOptions(std::size_t capacity, std::size_t drain_batch) {
+    outman::ChannelOptions options;
+    options.ingestion = outman::IngestionMode::Ring;
+    options.ring_capacity = capacity;
+    options.drain_batch = drain_batch;
+    return options;
+}
+
+void RunProducers(outman::OutputManager& manager, int producers, int records) {
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&manager, p, records]() {
+            for (int i = 0; i < records; ++i) {
+                manager.SaveAsync(p * kStride + i, outman::SenderId());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// Producers racing into a small ring keep their own order at every strategy.
+void OrderPerProducer(std::size_t workers) {
+    constexpr int producers = 4;
+    constexpr int records = 20000;
+
+    outman::OutputManagerConfig config;
+    config.worker_count = workers;
+    outman::OutputManager manager(config);
+    manager.ConfigureChannel<int>(RingOptions(256, 64));
+    auto first = std::make_shared<RecordingStrat>();
+    auto second = std::make_shared<RecordingStrat>();
+    manager.AddStrategy<int>(first);
+    manager.AddStrategy<int>(second);
+
+    RunProducers(manager, producers, records);
+    auto report = manager.Shutdown(std::chrono::steady_clock::now() + std::chrono::seconds(30));
+    CHECK(report.drained);
+    CHECK(manager.GetIngestionStats<int>().rejected == 0);
+    CheckComplete(first->Saved(), producers, records);
+    CheckComplete(second->Saved(), producers, records);
+}
+
+// A full Block queue holds records in the ring, so producers wait there
+// rather than have the drain reject them.
+void BlockQueueBehindRing(std::size_t workers) {
+    constexpr int producers = 3;
+    constexpr int records = 2000;
+
+    outman::OutputManagerConfig config;
+    config.worker_count = workers;
+    outman::OutputManager manager(config);
+    manager.ConfigureChannel<int>(RingOptions(64, 32));
+    auto slow = std::make_shared<RecordingStrat>(std::chrono::microseconds(20));
+    auto fast = std::make_shared<RecordingStrat>();
+    outman::QueueLimits limits;
+    limits.capacity = 16;
+    limits.policy = outman::BackpressurePolicy::Block;
+    manager.AddStrategy<int>(slow, limits);
+    manager.AddStrategy<int>(fast);
+
+    RunProducers(manager, producers, records);
+    auto report = manager.Shutdown(std::chrono::steady_clock::now() + std::chrono::seconds(30));
+    CHECK(report.drained);
+    CHECK(manager.GetBackpressureStats<int>()[0].rejected == 0);
+    CHECK(manager.GetIngestionStats<int>().blocked > 0);
+    CheckComplete(slow->Saved(), producers, records);
+    CheckComplete(fast->Saved(), producers, records);
+}
+
+// TrySaveAsync reports a full ring as rejected; what it accepted arrives.
+void TrySaveOnFullRing() {
+    std::promise<void> release;
+    outman::OutputManager manager;
+    manager.ConfigureChannel<int>(RingOptions(8, 4));
+    auto strategy = std::make_shared<RecordingStrat>(std::chrono::microseconds(0), release.get_future().share());
+    outman::QueueLimits limits;
+    limits.capacity = 4;
+    limits.policy = outman::BackpressurePolicy::Block;
+    manager.AddStrategy<int>(strategy, limits);
+
+    manager.SaveAsync(0, outman::SenderId());
+    CHECK(test_check::WaitFor([&strategy]() { return strategy->Entered(); }, milliseconds(5000)));
+
+    std::vector<int> accepted{ 0 };
+    for (int i = 1; i <= 100; ++i) {
+        if (manager.TrySaveAsync(i, outman::SenderId()).Ok()) {
+            accepted.push_back(i);
+        }
+    }
+    auto ingestion = manager.GetIngestionStats<int>();
+    CHECK(ingestion.rejected > 0);
+    CHECK(ingestion.rejected + accepted.size() == 101);
+    // The queue and the ring hold at most 4 + 8 records.
+    CHECK(accepted.size() <= 13);
+
+    release.set_value();
+    manager.Shutdown(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    CHECK(strategy->Saved() == accepted);
+    CHECK(manager.GetBackpressureStats<int>()[0].rejected == 0);
+}
+
+int main() {
+    OrderPerProducer(1);
+    OrderPerProducer(3);
+    BlockQueueBehindRing(1);
+    BlockQueueBehindRing(3);
+    TrySaveOnFullRing();
+    return test_check::Result("ring_ingestion");
+}
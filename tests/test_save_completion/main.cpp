@@ -0,0 +1,167 @@
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <stdexcept>
+
+#include <outman/outman.hpp>
+#include "outman/all_strats.hpp"
+
+#include "test_check.hpp"
+
+using std::chrono::milliseconds;
+
+struct Slow {
+    int value;
+};
+
+struct Fast {
+    int value;
+};
+
+// Counts its saves; the first Save waits for `gate` when one is given, and
+// the record `fail_on` throws.
+template <typename TData>
+class CountingStrat : public ISavingStrategy<TData> {
+public:
+    explicit CountingStrat(std::shared_future<void> gate = {}, int fail_on = -1)
+        : gate_(std::move(gate)), fail_on_(fail_on) {}
+
+    void Save(const TData& data, outman::SenderId /*sender*/) override {
+        if (!entered_.exchange(true) && gate_.valid()) {
+            gate_.wait();
+        }
+        if (data.value == fail_on_) {
+            throw std::runtime_error("save failed");
+        }
+        ++saved_;
+    }
+
+    bool Entered() const {
+        return entered_;
+    }
+
+    int Saved() const {
+        return saved_;
+    }
+
+private:
+    std::shared_future<void> gate_;
+    int fail_on_;
+    std::atomic<bool> entered_{ false };
+    std::atomic<int> saved_{ 0 };
+};
+
+template <typename TFuture>
+bool Ready(TFuture& future, milliseconds timeout) {
+    return future.wait_for(timeout) == std::future_status::ready;
+}
+
+template <typename TError, typename TFuture>
+bool Throws(TFuture& future) {
+    try {
+        future.get();
+    }
+    catch (const TError&) {
+        return true;
+    }
+    catch (...) {
+    }
+    return false;
+}
+
+// The watermark stops below a save that has not completed, however many
+// later saves have, and catches up once it does.
+void WatermarkWaitsForGap() {
+    std::promise<void> release;
+    outman::OutputManager manager;
+    auto slow = std::make_shared<CountingStrat<Slow>>(release.get_future().share());
+    auto fast = std::make_shared<CountingStrat<Fast>>();
+    manager.AddStrategy<Slow>(slow);
+    manager.AddStrategy<Fast>(fast);
+
+    std::uint64_t first = manager.SaveAsyncTracked(Slow{ 0 }, outman::SenderId());
+    std::uint64_t last = first;
+    for (int i = 0; i < 10; ++i) {
+        last = manager.SaveAsyncTracked(Fast{ i }, outman::SenderId());
+    }
+    CHECK(last == first + 10);
+    CHECK(test_check::WaitFor([&fast]() { return fast->Saved() == 10; }, milliseconds(5000)));
+    CHECK(manager.DurableWatermark() == first - 1);
+    CHECK(!manager.WaitUntilDurable(first, milliseconds(50)));
+
+    release.set_value();
+    CHECK(manager.WaitUntilDurable(last, std::chrono::seconds(5)));
+    CHECK(manager.DurableWatermark() == last);
+}
+
+// A failed save still completes its sequence.
+void WatermarkPassesFailures() {
+    outman::OutputManager manager;
+    manager.AddStrategy<Fast>(std::make_shared<CountingStrat<Fast>>(std::shared_future<void>(), 3));
+
+    std::uint64_t last = 0;
+    for (int i = 0; i < 6; ++i) {
+        last = manager.SaveAsyncTracked(Fast{ i }, outman::SenderId());
+    }
+    CHECK(manager.WaitUntilDurable(last, std::chrono::seconds(5)));
+    CHECK(manager.DurableWatermark() == last);
+}
+
+// The token completes once every strategy took the record, with the first
+// error any of them raised.
+void TokenCarriesErrors() {
+    outman::OutputManager manager;
+    auto ok = std::make_shared<CountingStrat<Fast>>();
+    manager.AddStrategy<Fast>(ok);
+    manager.AddStrategy<Fast>(std::make_shared<CountingStrat<Fast>>(std::shared_future<void>(), 7));
+
+    auto fine = manager.SaveAsync(Fast{ 1 }, outman::SenderId(), boost::asio::use_future);
+    CHECK(Ready(fine, milliseconds(5000)));
+    CHECK(!Throws<std::exception>(fine));
+    CHECK(ok->Saved() == 1);
+
+    auto failing = manager.SaveAsync(Fast{ 7 }, outman::SenderId(), boost::asio::use_future);
+    CHECK(Ready(failing, milliseconds(5000)));
+    CHECK(Throws<std::runtime_error>(failing));
+    CHECK(ok->Saved() == 2);
+}
+
+// A record its queue drops completes with RecordDroppedError right away,
+// and saves after Shutdown with OutputStoppedError.
+void TokenReportsDropsAndShutdown() {
+    std::promise<void> release;
+    outman::OutputManager manager;
+    auto gated = std::make_shared<CountingStrat<Fast>>(release.get_future().share());
+    outman::QueueLimits limits;
+    limits.capacity = 1;
+    limits.policy = outman::BackpressurePolicy::DropNewest;
+    manager.AddStrategy<Fast>(gated, limits);
+
+    auto taken = manager.SaveAsync(Fast{ 0 }, outman::SenderId(), boost::asio::use_future);
+    CHECK(test_check::WaitFor([&gated]() { return gated->Entered(); }, milliseconds(5000)));
+    auto queued = manager.SaveAsync(Fast{ 1 }, outman::SenderId(), boost::asio::use_future);
+    auto dropped = manager.SaveAsync(Fast{ 2 }, outman::SenderId(), boost::asio::use_future);
+    CHECK(Ready(dropped, milliseconds(5000)));
+    CHECK(Throws<outman::RecordDroppedError>(dropped));
+    CHECK(!Ready(queued, milliseconds(20)));
+
+    release.set_value();
+    CHECK(Ready(taken, milliseconds(5000)) && !Throws<std::exception>(taken));
+    CHECK(Ready(queued, milliseconds(5000)) && !Throws<std::exception>(queued));
+    CHECK(gated->Saved() == 2);
+
+    manager.Shutdown(std::chrono::steady_clock::now() + std::chrono::seconds(5));
+    auto stopped = manager.SaveAsync(Fast{ 3 }, outman::SenderId(), boost::asio::use_future);
+    CHECK(Ready(stopped, milliseconds(5000)));
+    CHECK(Throws<outman::OutputStoppedError>(stopped));
+}
+
+int main() {
+    WatermarkWaitsForGap();
+    WatermarkPassesFailures();
+    TokenCarriesErrors();
+    TokenReportsDropsAndShutdown();
+    return test_check::Result("save_completion");
+}
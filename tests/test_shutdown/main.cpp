@@ -0,0 +1,157 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+
+#include <outman/outman.hpp>
+#include "outman/all_strats.hpp"
+
+#include "test_check.hpp"
+
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+// Counts its saves; the first Save waits for `gate` when one is given.
+class CountingStrat : public ISavingStrategy<int> {
+public:
+    explicit CountingStrat(std::shared_future<void> gate = {}) : gate_(std::move(gate)) {}
+
+    void Save(const int& /*data*/, outman::SenderId /*sender*/) override {
+        if (!entered_.exchange(true) && gate_.valid()) {
+            gate_.wait();
+        }
+        ++saved_;
+    }
+
+    bool Entered() const {
+        return entered_;
+    }
+
+    int Saved() const {
+        return saved_;
+    }
+
+private:
+    std::shared_future<void> gate_;
+    std::atomic<bool> entered_{ false };
+    std::atomic<int> saved_{ 0 };
+};
+
+// Buffers records until flushed; notes how many were added before the
+// last flush.
+class BufferingStrat : public BaseFlushableSavingStrategy<int> {
+public:
+    void AddAsync(const int& /*data*/, outman::SenderId /*sender*/) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++added_;
+    }
+
+    void FlushAsync(outman::SenderId /*sender*/) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++flushes_;
+        flushed_ = added_;
+    }
+
+    int Added() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return added_;
+    }
+
+    int Flushes() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return flushes_;
+    }
+
+    int Flushed() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return flushed_;
+    }
+
+private:
+    std::mutex mutex_;
+    int added_ = 0;
+    int flushes_ = 0;
+    int flushed_ = 0;
+};
+
+// Shutdown drains every queue (and the ring), flushes after the last
+// record, and later saves are counted as rejected.
+void DrainsAndRejects(bool ring) {
+    constexpr int records = 5000;
+
+    outman::OutputManager manager;
+    if (ring) {
+        outman::ChannelOptions options;
+        options.ingestion = outman::IngestionMode::Ring;
+        options.ring_capacity = 128;
+        manager.ConfigureChannel<int>(options);
+    }
+    auto counting = std::make_shared<CountingStrat>();
+    auto buffering = std::make_shared<BufferingStrat>();
+    manager.AddStrategy<int>(counting);
+    manager.AddStrategy<int>(buffering);
+
+    for (int i = 0; i < records; ++i) {
+        manager.SaveAsync(i, outman::SenderId());
+    }
+    auto report = manager.Shutdown(steady_clock::now() + std::chrono::seconds(30));
+    CHECK(report.drained);
+    CHECK(report.unwritten == 0);
+    CHECK(report.rejected == 0);
+    CHECK(counting->Saved() == records);
+    CHECK(buffering->Added() == records);
+    CHECK(buffering->Flushes() >= 1);
+    CHECK(buffering->Flushed() == records);
+
+    for (int i = 0; i < 3; ++i) {
+        manager.SaveAsync(i, outman::SenderId());
+    }
+    auto result = manager.TrySaveAsync(3, outman::SenderId());
+    CHECK(result.accepted == 0);
+    CHECK(result.rejected == 2);
+
+    report = manager.Shutdown(steady_clock::now() + std::chrono::seconds(5));
+    CHECK(report.drained);
+    CHECK(report.rejected == 4);
+    CHECK(counting->Saved() == records);
+}
+
+// A strategy stuck past the deadline leaves its queue unwritten; a later
+// Shutdown picks up where the first stopped.
+void DeadlineLeavesUnwritten() {
+    constexpr int queued = 100;
+    constexpr milliseconds deadline(50);
+
+    std::promise<void> release;
+    outman::OutputManager manager;
+    auto gated = std::make_shared<CountingStrat>(release.get_future().share());
+    manager.AddStrategy<int>(gated);
+
+    manager.SaveAsync(0, outman::SenderId());
+    CHECK(test_check::WaitFor([&gated]() { return gated->Entered(); }, milliseconds(5000)));
+    for (int i = 1; i <= queued; ++i) {
+        manager.SaveAsync(i, outman::SenderId());
+    }
+
+    auto report = manager.Shutdown(steady_clock::now() + deadline);
+    CHECK(!report.drained);
+    CHECK(report.unwritten == static_cast<std::size_t>(queued));
+    CHECK(report.rejected == 0);
+    CHECK(report.elapsed >= deadline);
+    CHECK(report.elapsed < std::chrono::seconds(5));
+    CHECK(gated->Saved() == 0);
+
+    release.set_value();
+    report = manager.Shutdown(steady_clock::now() + std::chrono::seconds(5));
+    CHECK(report.drained);
+    CHECK(report.unwritten == 0);
+    CHECK(gated->Saved() == queued + 1);
+}
+
+int main() {
+    DrainsAndRejects(false);
+    DrainsAndRejects(true);
+    DeadlineLeavesUnwritten();
+    return test_check::Result("shutdown");
+}
@@ -0,0 +1,107 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+#include <outman/outman.hpp>
+
+#include "test_check.hpp"
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+bool Near(long actual, long expected, long tolerance) {
+    return std::labs(actual - expected) <= tolerance;
+}
+
+// Driving the wheel with explicit times: every entry fires once per
+// interval, whether it fits in one turn of the wheel or takes several.
+void IntervalsOnOneWheel() {
+    outman::detail::TimerWheel wheel(milliseconds(1), 8);
+    int short_fires = 0;
+    int long_fires = 0;
+    auto short_entry = wheel.Add([&short_fires]() { ++short_fires; }, milliseconds(3));
+    auto long_entry = wheel.Add([&long_fires]() { ++long_fires; }, milliseconds(20));
+    auto fire = [](const std::shared_ptr<outman::detail::TimerEntry>& entry) {
+        entry->callback();
+    };
+
+    auto start = Clock::now();
+    wheel.Advance(start, fire);
+    for (int ms = 1; ms <= 120; ++ms) {
+        wheel.Advance(start + milliseconds(ms), fire);
+    }
+    CHECK(Near(short_fires, 40, 1));
+    CHECK(Near(long_fires, 6, 1));
+
+    // Skipping ahead in one step still runs every tick on the way.
+    wheel.Advance(start + milliseconds(240), fire);
+    CHECK(Near(short_fires, 80, 1));
+    CHECK(Near(long_fires, 12, 1));
+    (void)short_entry;
+    (void)long_entry;
+}
+
+// An idle wheel sleeps until its earliest entry is due, not tick by tick.
+void NextTickIsEarliestDue() {
+    outman::detail::TimerWheel wheel(milliseconds(1), 8);
+    auto fire = [](const std::shared_ptr<outman::detail::TimerEntry>& entry) {
+        entry->callback();
+    };
+    auto start = Clock::now();
+    wheel.Advance(start, fire);
+    CHECK(wheel.NextTick() == Clock::time_point::max());
+
+    auto entry = wheel.Add([]() {}, milliseconds(20));
+    // Not yet scheduled: the next tick takes it in.
+    CHECK(wheel.NextTick() - start <= milliseconds(1));
+
+    wheel.Advance(start, fire);
+    auto wait = wheel.NextTick() - start;
+    CHECK(wait > milliseconds(19) && wait <= milliseconds(20));
+
+    wheel.Advance(start + milliseconds(5), fire);
+    wait = wheel.NextTick() - (start + milliseconds(5));
+    CHECK(wait > milliseconds(14) && wait <= milliseconds(15));
+
+    // A cancelled entry is due when its slot comes up, which drops it.
+    entry->cancelled = true;
+    wait = wheel.NextTick() - (start + milliseconds(5));
+    CHECK(wait <= milliseconds(8));
+    wheel.Advance(wheel.NextTick(), fire);
+    CHECK(wheel.NextTick() == Clock::time_point::max());
+}
+
+// Registered flushes run at their own intervals through the manager's timer.
+void ManagerFlushIntervals() {
+    outman::OutputManagerConfig config;
+    config.flush_tick = milliseconds(5);
+    outman::OutputManager manager(config);
+
+    std::atomic<int> fast{ 0 };
+    std::atomic<int> slow{ 0 };
+    auto fast_registration = manager.RegisterFlush([&fast]() { ++fast; }, milliseconds(20));
+    auto slow_registration = manager.RegisterFlush([&slow]() { ++slow; }, milliseconds(100));
+
+    std::this_thread::sleep_for(milliseconds(500));
+    fast_registration.Cancel();
+    slow_registration.Cancel();
+    int fast_count = fast;
+    int slow_count = slow;
+
+    CHECK(fast_count >= 15 && fast_count <= 26);
+    CHECK(slow_count >= 3 && slow_count <= 5);
+
+    // Cancelled flushes stop for good.
+    std::this_thread::sleep_for(milliseconds(100));
+    CHECK(fast <= fast_count + 1);
+    CHECK(slow <= slow_count + 1);
+}
+
+int main() {
+    IntervalsOnOneWheel();
+    NextTickIsEarliestDue();
+    ManagerFlushIntervals();
+    return test_check::Result("timer_wheel");
+}